@@ -0,0 +1,215 @@
+// Builds, inspects and extracts examples::AssetPack files, and compares reading
+// their entries against reading the same files from disk one by one.
+//
+// Usage:
+//   example-asset-pack pack OUTPUT [--compress] [--root=DIR] FILE...
+//       Entries are named after the files' paths, without the DIR/ prefix.
+//   example-asset-pack list PACK
+//   example-asset-pack unpack PACK DIR
+//   example-asset-pack bench PACK [--root=DIR] [--runs=N]
+//       Reads every entry from the pack and from DIR/<entry>, N times each.
+
+#include <examples/assetpack.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    bool ReadFile(const std::string& path, std::string& contents) {
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file)
+            return false;
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        contents = stream.str();
+        return true;
+    }
+
+    // Creates every missing directory of path's parent.
+    void MakeParentDirectories(const std::string& path) {
+        for (std::size_t slash = path.find('/', 1); slash != std::string::npos; slash = path.find('/', slash + 1)) {
+            std::string directory = path.substr(0, slash);
+#ifdef _WIN32
+            _mkdir(directory.c_str());
+#else
+            mkdir(directory.c_str(), 0755);
+#endif
+        }
+    }
+
+    std::string EntryName(const std::string& path, const std::string& root) {
+        if (root.empty() || path.compare(0, root.size(), root) != 0)
+            return path;
+        std::size_t begin = root.size();
+        while (begin < path.size() && path[begin] == '/')
+            ++begin;
+        return path.substr(begin);
+    }
+
+    int Pack(int argc, char* argv[]) {
+        if (argc < 3) {
+            std::fprintf(stderr, "Usage: %s pack OUTPUT [--compress] [--root=DIR] FILE...\n", argv[0]);
+            return 1;
+        }
+        bool compress = false;
+        std::string root;
+        examples::AssetPackWriter writer;
+        std::size_t total = 0;
+        for (int i = 3; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--compress") == 0)
+                compress = true;
+            else if (std::strncmp(argv[i], "--root=", 7) == 0)
+                root = argv[i] + 7;
+        }
+        for (int i = 3; i < argc; ++i) {
+            if (std::strncmp(argv[i], "--", 2) != 0) {
+                std::string contents;
+                if (!ReadFile(argv[i], contents)) {
+                    std::fprintf(stderr, "Unable to open '%s'.\n", argv[i]);
+                    return 1;
+                }
+                total += contents.size();
+                writer.Add(EntryName(argv[i], root), contents, compress);
+            }
+        }
+        if (!writer.Write(argv[2]))
+            return 1;
+        examples::AssetPack pack(argv[2]);
+        std::size_t stored = 0;
+        for (std::size_t i = 0; i < pack.num_entries(); ++i)
+            stored += static_cast<std::size_t>(pack.entry(i).stored_size);
+        printf("Packed %u files, %u bytes, into '%s' (%u bytes of data).\n", static_cast<unsigned>(writer.size()),
+               static_cast<unsigned>(total), argv[2], static_cast<unsigned>(stored));
+        return 0;
+    }
+
+    int List(int argc, char* argv[]) {
+        if (argc != 3) {
+            std::fprintf(stderr, "Usage: %s list PACK\n", argv[0]);
+            return 1;
+        }
+        examples::AssetPack pack(argv[2]);
+        if (!pack.is_open())
+            return 1;
+        for (std::size_t i = 0; i < pack.num_entries(); ++i) {
+            const examples::PackEntry& entry = pack.entry(i);
+            printf("%10llu %10llu %s %s\n", static_cast<unsigned long long>(entry.size),
+                   static_cast<unsigned long long>(entry.stored_size),
+                   entry.compression == examples::PackEntry::LZ ? "lz    " : "stored", pack.path(i).c_str());
+        }
+        return 0;
+    }
+
+    int Unpack(int argc, char* argv[]) {
+        if (argc != 4) {
+            std::fprintf(stderr, "Usage: %s unpack PACK DIR\n", argv[0]);
+            return 1;
+        }
+        examples::AssetPack pack(argv[2]);
+        if (!pack.is_open())
+            return 1;
+        for (std::size_t i = 0; i < pack.num_entries(); ++i) {
+            std::string path = std::string(argv[3]) + "/" + pack.path(i);
+            examples::AssetView view = pack.Get(i);
+            if (!view.found())
+                return 1;
+            MakeParentDirectories(path);
+            FILE* out = std::fopen(path.c_str(), "wb");
+            bool ok = out && std::fwrite(view.data, 1, view.size, out) == view.size;
+            if (out)
+                ok = std::fclose(out) == 0 && ok;
+            if (!ok) {
+                std::fprintf(stderr, "Unable to write '%s'.\n", path.c_str());
+                return 1;
+            }
+        }
+        printf("Unpacked %u files into '%s'.\n", static_cast<unsigned>(pack.num_entries()), argv[3]);
+        return 0;
+    }
+
+    int Bench(int argc, char* argv[]) {
+        if (argc < 3) {
+            std::fprintf(stderr, "Usage: %s bench PACK [--root=DIR] [--runs=N]\n", argv[0]);
+            return 1;
+        }
+        std::string root = ".";
+        int runs = 5;
+        for (int i = 3; i < argc; ++i) {
+            if (std::strncmp(argv[i], "--root=", 7) == 0)
+                root = argv[i] + 7;
+            else if (std::strncmp(argv[i], "--runs=", 7) == 0)
+                runs = std::max(1, std::atoi(argv[i] + 7));
+        }
+
+        Clock::time_point begin = Clock::now();
+        examples::AssetPack pack(argv[2]);
+        double open_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        if (!pack.is_open())
+            return 1;
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; i < pack.num_entries(); ++i)
+            paths.push_back(pack.path(i));
+
+        // Both sides touch every cache line of the contents, so both pay for their page faults.
+        unsigned long long loose_sum = 0, pack_sum = 0;
+        double loose_ms = 0.0, pack_ms = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            begin = Clock::now();
+            for (const std::string& path : paths) {
+                std::string contents;
+                if (!ReadFile(root + "/" + path, contents)) {
+                    std::fprintf(stderr, "Unable to open '%s/%s'.\n", root.c_str(), path.c_str());
+                    return 1;
+                }
+                for (std::size_t k = 0; k < contents.size(); k += 64)
+                    loose_sum += static_cast<unsigned char>(contents[k]);
+            }
+            loose_ms += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+            begin = Clock::now();
+            for (const std::string& path : paths) {
+                examples::AssetView view = pack.Get(path);
+                for (std::size_t k = 0; k < view.size; k += 64)
+                    pack_sum += static_cast<unsigned char>(view.data[k]);
+            }
+            pack_ms += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+        }
+        printf("%u entries: pack opened in %.3f ms; loose files %.3f ms/run, pack %.3f ms/run (%.1fx)\n",
+               static_cast<unsigned>(paths.size()), open_ms, loose_ms / runs, pack_ms / runs,
+               loose_ms / std::max(pack_ms, 1e-6));
+        if (loose_sum != pack_sum) {
+            std::fprintf(stderr, "The pack's contents differ from the loose files.\n");
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "pack")
+        return Pack(argc, argv);
+    if (command == "list")
+        return List(argc, argv);
+    if (command == "unpack")
+        return Unpack(argc, argv);
+    if (command == "bench")
+        return Bench(argc, argv);
+    std::fprintf(stderr, "Usage: %s pack|list|unpack|bench ...\n", argc > 0 ? argv[0] : "example-asset-pack");
+    return 1;
+}
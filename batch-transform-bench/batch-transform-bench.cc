@@ -0,0 +1,150 @@
+// Compares composing a parent transform with many children and writing their
+// quads' corners one node at a time, the way each Canvas::PushAndCompose of a
+// Geometry does, against examples::TransformQuads on a whole batch, in double
+// precision and in float with the scalar, SSE and AVX paths.
+//
+// Usage: example-batch-transform-bench [--max=N] [--repeat=N]
+//   --max=N      largest batch, from 1k up by factors of 10 (default 1000000)
+//   --repeat=N   passes over each batch (default: enough for ~10M transforms)
+
+#include <examples/batchtransform.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    typedef examples::Affine2D Affine2D;
+
+    const double quad_width = 4.0, quad_height = 3.0;
+
+    // Keeps the compiler from dropping work whose result is otherwise unused.
+    volatile double sink;
+
+    Affine2D Scale(double x, double y) {
+        Affine2D result;
+        result.a = x;
+        result.d = y;
+        return result;
+    }
+
+    Affine2D Rotation(double angle) {
+        Affine2D result;
+        result.a = result.d = std::cos(angle);
+        result.b = std::sin(angle);
+        result.c = -result.b;
+        return result;
+    }
+
+    // One node as ugdk draws it: a Geometry of its own, composed with the parent's,
+    // then applied to each corner of its quad.
+    struct Node {
+        Affine2D local;
+    };
+
+    void TransformNodes(const Affine2D& parent, const std::vector<Node>& nodes, double* out) {
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            Affine2D world = parent * nodes[i].local;
+            const double corners[4][2] = { { 0.0, 0.0 }, { quad_width, 0.0 },
+                                           { quad_width, quad_height }, { 0.0, quad_height } };
+            double* v = out + 8 * i;
+            for (int k = 0; k < 4; ++k) {
+                v[2 * k] = world.a * corners[k][0] + world.c * corners[k][1] + world.tx;
+                v[2 * k + 1] = world.b * corners[k][0] + world.d * corners[k][1] + world.ty;
+            }
+        }
+    }
+
+    template<typename Function>
+    double NanosecondsPerTransform(std::size_t count, int repeat, Function function) {
+        Clock::time_point begin = Clock::now();
+        for (int r = 0; r < repeat; ++r)
+            function();
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / (double(count) * repeat);
+    }
+
+    template<typename Real>
+    double MaxError(const std::vector<double>& expected, const std::vector<Real>& actual) {
+        double error = 0.0;
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            error = std::max(error, std::fabs(expected[i] - static_cast<double>(actual[i])));
+        return error;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t max_count = 1000000;
+    int repeat = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--max=", 6) == 0)
+            max_count = std::max(1000, std::atoi(argv[i] + 6));
+        else if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = std::max(1, std::atoi(argv[i] + 9));
+    }
+
+    printf("best path: %s\n", examples::BatchPathName(examples::BestBatchPath()));
+    printf("%10s %12s %12s %12s %12s %12s   (ns/transform)\n", "transforms", "per-node", "batch f64",
+           "f32 scalar", "f32 sse", "f32 avx");
+
+    Affine2D parent = Affine2D::Translation(640.0, 360.0) * Rotation(0.3) * Scale(1.5, 1.5);
+    const examples::BatchPath paths[] = { examples::BatchPath::SCALAR, examples::BatchPath::SSE, examples::BatchPath::AVX };
+    for (std::size_t count = 1000; count <= max_count; count *= 10) {
+        std::default_random_engine engine(11);
+        std::uniform_real_distribution<double> position(-600.0, 600.0), scale(0.5, 2.0), angle(-3.1416, 3.1416);
+        std::vector<Node> nodes(count);
+        examples::TransformBatch<double> batch64;
+        examples::TransformBatch<float> batch32;
+        batch64.resize(count);
+        batch32.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            double x = position(engine), y = position(engine), sx = scale(engine), sy = scale(engine), r = angle(engine);
+            nodes[i].local = Affine2D::Translation(x, y) * Rotation(r) * Scale(sx, sy);
+            batch64.Set(i, x, y, sx, sy, r);
+            batch32.Set(i, x, y, sx, sy, r);
+        }
+        int passes = repeat > 0 ? repeat : static_cast<int>(std::max<std::size_t>(1, 10000000 / count));
+
+        std::vector<double> expected(8 * count), out64(8 * count);
+        std::vector<float> out32(8 * count);
+        double per_node = NanosecondsPerTransform(count, passes, [&] {
+            TransformNodes(parent, nodes, expected.data());
+            sink = expected[count];
+        });
+        double batch_f64 = NanosecondsPerTransform(count, passes, [&] {
+            examples::TransformQuads(parent, batch64, quad_width, quad_height, out64.data());
+            sink = out64[count];
+        });
+        double error = MaxError(expected, out64);
+
+        printf("%10u %12.3f %12.3f", static_cast<unsigned>(count), per_node, batch_f64);
+        double float_error = 0.0;
+        for (examples::BatchPath path : paths) {
+            if (!examples::BatchPathSupported(path)) {
+                printf(" %12s", "-");
+                continue;
+            }
+            std::fill(out32.begin(), out32.end(), 0.0f);
+            double ns = NanosecondsPerTransform(count, passes, [&] {
+                examples::TransformQuads(parent, batch32, static_cast<float>(quad_width),
+                                         static_cast<float>(quad_height), out32.data(), path);
+                sink = out32[count];
+            });
+            float_error = std::max(float_error, MaxError(expected, out32));
+            printf(" %12.3f", ns);
+        }
+        printf("   max error f64 %.2g, f32 %.2g\n", error, float_error);
+
+        // Float positions are within a few hundredths of a pixel of the doubles here.
+        if (error > 1e-9 || float_error > 0.05) {
+            std::fprintf(stderr, "The batch positions differ from the per-node ones.\n");
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -1,17 +1,31 @@
 #include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
 #include <ugdk/action/scene.h>
 #include <ugdk/input/events.h>
 #include <ugdk/system/compatibility.h>
 
+#include <examples/benchmark.h>
+#include <examples/inputrecord.h>
+
 void QuitOnEscape(const ugdk::input::KeyPressedEvent& ev) {
     if (ev.scancode == ugdk::input::Scancode::ESCAPE)
         ugdk::system::CurrentScene().Finish();
 }
 
 int main(int argc, char* argv[]) {
-    ugdk::system::Initialize();
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+    examples::InputRecordingOptions input_options = examples::ParseInputRecordingOptions(argc, argv);
+    examples::InputRecorder recorder(input_options.record_path);
+    examples::InputReplay replay(input_options.replay_path);
+
+    ugdk::system::Configuration config;
+    bench.Configure(config);
+    ugdk::system::Initialize(config);
 
     auto ourscene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*ourscene);
+    recorder.Attach(*ourscene);
+    replay.Attach(*ourscene);
     ourscene->event_handler().AddListener(QuitOnEscape);
     ugdk::system::PushScene(std::move(ourscene));
 
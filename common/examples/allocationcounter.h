@@ -0,0 +1,275 @@
+#ifndef UGDK_EXAMPLES_ALLOCATIONCOUNTER_H_
+#define UGDK_EXAMPLES_ALLOCATIONCOUNTER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace examples {
+
+// Counts every allocation made through the global operator new, and optionally
+// the time spent in operator new and delete.
+//
+// Exactly one source file of the program must replace the global operators by
+// defining EXAMPLES_ALLOCATION_COUNTER_IMPLEMENTATION before including this header.
+// Without that the counters stay at zero.
+//
+// Allocations are also tagged with the engine module they were made for, set by
+// the innermost MemoryTagScope of the allocating thread. Each allocation keeps a
+// 16 byte header with its size and tag, so it's accounted to the same tag when it
+// is freed wherever that happens.
+//
+// Each thread keeps its counts to itself and adds them to the totals every few
+// dozen calls, so totals read from one thread can miss the latest calls of the
+// others, and a peak can read up to 64 KiB per thread low.
+struct AllocationStats {
+    unsigned long long allocations;
+    unsigned long long deallocations;
+    unsigned long long bytes;
+    unsigned long long nanoseconds;
+
+    AllocationStats operator-(const AllocationStats& other) const {
+        AllocationStats result = {
+            allocations - other.allocations, deallocations - other.deallocations,
+            bytes - other.bytes, nanoseconds - other.nanoseconds
+        };
+        return result;
+    }
+};
+
+// Modules memory is accounted to. OTHER is everything outside a MemoryTagScope.
+// POOL is the chunks of every PoolResource, which hold objects of any module.
+enum class MemoryTag : unsigned char {
+    OTHER, GRAPHIC, TEXT, UI, INPUT, FILESYSTEM, ACTION, POOL,
+};
+
+const std::size_t NUM_MEMORY_TAGS = 8;
+
+inline const char* MemoryTagName(MemoryTag tag) {
+    static const char* const names[NUM_MEMORY_TAGS] = {
+        "other", "graphic", "text", "ui", "input", "filesystem", "action", "pool",
+    };
+    return names[static_cast<std::size_t>(tag)];
+}
+
+struct MemoryTagStats {
+    unsigned long long current_bytes;
+    unsigned long long peak_bytes;
+    unsigned long long live_objects;
+};
+
+namespace internal {
+    struct TagCounters {
+        std::atomic<unsigned long long> current_bytes, peak_bytes, live_objects;
+    };
+
+    struct AllocationCounters {
+        std::atomic<unsigned long long> allocations, deallocations, bytes, nanoseconds;
+        std::atomic<bool> timing;
+        TagCounters tags[NUM_MEMORY_TAGS];
+    };
+
+    // The counts of one thread not yet added to AllocationCounters. Adding them on
+    // every call took several atomic operations on lines shared by all threads,
+    // which doubled the cost of a new and delete pair.
+    struct PendingCounters {
+        unsigned operations;
+        bool registered, exiting;
+        unsigned long long allocations, deallocations, bytes, nanoseconds;
+        long long tag_bytes[NUM_MEMORY_TAGS], tag_objects[NUM_MEMORY_TAGS];
+    };
+
+    // Pending counts are added after this many operations, or once a tag's bytes
+    // grew by this much, so a peak reads at most that much low per thread.
+    const unsigned FLUSH_OPERATIONS = 64;
+    const long long FLUSH_BYTES = 64 * 1024;
+
+    // Keeps the memory after it aligned like malloc's.
+    struct alignas(16) AllocationHeader {
+        std::size_t size;
+        MemoryTag tag;
+    };
+
+    inline MemoryTag& CurrentTag() {
+        static thread_local MemoryTag tag = MemoryTag::OTHER;
+        return tag;
+    }
+
+    // Zero-initialized before any dynamic initialization, so it's safe to use from
+    // allocations made by static constructors.
+    inline AllocationCounters& Counters() {
+        static AllocationCounters counters;
+        return counters;
+    }
+
+    // Trivially destructible, so it's still usable by whatever the thread frees
+    // after its thread_local objects are destroyed.
+    inline PendingCounters& Pending() {
+        static thread_local PendingCounters pending;
+        return pending;
+    }
+
+    inline void Flush(PendingCounters& pending) {
+        AllocationCounters& counters = Counters();
+        counters.allocations.fetch_add(pending.allocations, std::memory_order_relaxed);
+        counters.deallocations.fetch_add(pending.deallocations, std::memory_order_relaxed);
+        counters.bytes.fetch_add(pending.bytes, std::memory_order_relaxed);
+        counters.nanoseconds.fetch_add(pending.nanoseconds, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < NUM_MEMORY_TAGS; ++i) {
+            if (pending.tag_bytes[i] == 0 && pending.tag_objects[i] == 0)
+                continue;
+            // Negative deltas wrap around, which adds them as well as subtracting would.
+            TagCounters& tag = counters.tags[i];
+            tag.live_objects.fetch_add(static_cast<unsigned long long>(pending.tag_objects[i]),
+                                       std::memory_order_relaxed);
+            unsigned long long delta = static_cast<unsigned long long>(pending.tag_bytes[i]);
+            unsigned long long current = tag.current_bytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+            unsigned long long peak = tag.peak_bytes.load(std::memory_order_relaxed);
+            while (pending.tag_bytes[i] > 0 && current > peak
+                   && !tag.peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+                ;
+            pending.tag_bytes[i] = pending.tag_objects[i] = 0;
+        }
+        pending.operations = 0;
+        pending.allocations = pending.deallocations = pending.bytes = pending.nanoseconds = 0;
+    }
+
+    // Flushes the counts of a thread when it exits. Frees made after that, like
+    // those of static destructors on the main thread, are flushed one by one.
+    struct PendingFlusher {
+        ~PendingFlusher() {
+            PendingCounters& pending = Pending();
+            pending.exiting = true;
+            Flush(pending);
+        }
+    };
+
+    inline void Counted(PendingCounters& pending, bool flush) {
+        if (!pending.registered) {
+            pending.registered = true;
+            static thread_local PendingFlusher flusher;
+            (void) flusher;
+        }
+        if (flush || pending.exiting || ++pending.operations >= FLUSH_OPERATIONS)
+            Flush(pending);
+    }
+
+    inline unsigned long long Now() {
+        return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    inline void* CountedAllocate(std::size_t size) {
+        bool timing = Counters().timing.load(std::memory_order_relaxed);
+        unsigned long long begin = timing ? Now() : 0;
+        void* p = std::malloc(sizeof(AllocationHeader) + size);
+        PendingCounters& pending = Pending();
+        if (timing)
+            pending.nanoseconds += Now() - begin;
+        if (!p)
+            throw std::bad_alloc();
+        pending.allocations += 1;
+        pending.bytes += size;
+
+        AllocationHeader* header = static_cast<AllocationHeader*>(p);
+        header->size = size;
+        header->tag = CurrentTag();
+        std::size_t tag = static_cast<std::size_t>(header->tag);
+        pending.tag_objects[tag] += 1;
+        pending.tag_bytes[tag] += static_cast<long long>(size);
+        Counted(pending, pending.tag_bytes[tag] >= FLUSH_BYTES);
+        return header + 1;
+    }
+
+    inline void CountedFree(void* p) {
+        if (!p)
+            return;
+        PendingCounters& pending = Pending();
+        AllocationHeader* header = static_cast<AllocationHeader*>(p) - 1;
+        std::size_t tag = static_cast<std::size_t>(header->tag);
+        pending.tag_objects[tag] -= 1;
+        pending.tag_bytes[tag] -= static_cast<long long>(header->size);
+
+        bool timing = Counters().timing.load(std::memory_order_relaxed);
+        unsigned long long begin = timing ? Now() : 0;
+        std::free(header);
+        if (timing)
+            pending.nanoseconds += Now() - begin;
+        pending.deallocations += 1;
+        Counted(pending, false);
+    }
+}
+
+// Other threads' most recent calls may not be counted yet; the calling thread's are.
+inline AllocationStats CurrentAllocationStats() {
+    internal::Flush(internal::Pending());
+    internal::AllocationCounters& counters = internal::Counters();
+    AllocationStats stats = {
+        counters.allocations.load(std::memory_order_relaxed),
+        counters.deallocations.load(std::memory_order_relaxed),
+        counters.bytes.load(std::memory_order_relaxed),
+        counters.nanoseconds.load(std::memory_order_relaxed)
+    };
+    return stats;
+}
+
+// Timing costs two clock reads per call, so it's off by default.
+inline void EnableAllocationTiming(bool enable) {
+    internal::Counters().timing.store(enable, std::memory_order_relaxed);
+}
+
+inline MemoryTagStats CurrentMemoryStats(MemoryTag tag) {
+    internal::Flush(internal::Pending());
+    internal::TagCounters& counters = internal::Counters().tags[static_cast<std::size_t>(tag)];
+    MemoryTagStats stats = {
+        counters.current_bytes.load(std::memory_order_relaxed),
+        counters.peak_bytes.load(std::memory_order_relaxed),
+        counters.live_objects.load(std::memory_order_relaxed)
+    };
+    return stats;
+}
+
+// Accounts the allocations of the current thread to tag until it's destroyed.
+// Scopes nest: the previous tag is restored on destruction.
+class MemoryTagScope {
+  public:
+    explicit MemoryTagScope(MemoryTag tag)
+        : previous_(internal::CurrentTag())
+    {
+        internal::CurrentTag() = tag;
+    }
+
+    ~MemoryTagScope() {
+        internal::CurrentTag() = previous_;
+    }
+
+    MemoryTagScope(const MemoryTagScope&) = delete;
+    MemoryTagScope& operator=(const MemoryTagScope&) = delete;
+
+  private:
+    MemoryTag previous_;
+};
+
+// Writes the current and peak bytes and the live objects of every tag.
+inline void PrintMemoryReport(std::FILE* out) {
+    std::fprintf(out, "%-12s %12s %12s %12s\n", "module", "current KiB", "peak KiB", "live objects");
+    for (std::size_t i = 0; i < NUM_MEMORY_TAGS; ++i) {
+        MemoryTagStats stats = CurrentMemoryStats(static_cast<MemoryTag>(i));
+        std::fprintf(out, "%-12s %12.1f %12.1f %12llu\n", MemoryTagName(static_cast<MemoryTag>(i)),
+                     stats.current_bytes / 1024.0, stats.peak_bytes / 1024.0, stats.live_objects);
+    }
+}
+
+} // namespace examples
+
+#ifdef EXAMPLES_ALLOCATION_COUNTER_IMPLEMENTATION
+void* operator new(std::size_t size) { return examples::internal::CountedAllocate(size); }
+void* operator new[](std::size_t size) { return examples::internal::CountedAllocate(size); }
+void operator delete(void* p) noexcept { examples::internal::CountedFree(p); }
+void operator delete[](void* p) noexcept { examples::internal::CountedFree(p); }
+#endif
+
+#endif // UGDK_EXAMPLES_ALLOCATIONCOUNTER_H_
@@ -0,0 +1,282 @@
+#ifndef UGDK_EXAMPLES_ASSETLOADER_H_
+#define UGDK_EXAMPLES_ASSETLOADER_H_
+
+#include <ugdk/text/module.h>
+#include <ugdk/text/font.h>
+#include <ugdk/text/textbox.h>
+
+#include <examples/allocationcounter.h>
+#include <examples/assetpack.h>
+#include <examples/clock.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace examples {
+
+// Command line options for examples that load their content with an AssetLoader:
+//   --sync-loading       load everything on the main thread, before the first frame
+//   --loader-threads=N   number of worker threads (default 2)
+//   --asset-pack=PATH    read files from this pack (see asset-pack/) when it has them
+struct LoadingOptions {
+    LoadingOptions()
+        : synchronous(false)
+        , threads(2)
+    {}
+
+    bool synchronous;
+    unsigned threads;
+    std::string pack_path;
+};
+
+inline LoadingOptions ParseLoadingOptions(int argc, char* argv[]) {
+    LoadingOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strcmp(arg, "--sync-loading") == 0)
+            options.synchronous = true;
+        else if (std::strncmp(arg, "--loader-threads=", 17) == 0)
+            options.threads = static_cast<unsigned>(std::strtoul(arg + 17, nullptr, 10));
+        else if (std::strncmp(arg, "--asset-pack=", 13) == 0)
+            options.pack_path = arg + 13;
+    }
+    return options;
+}
+
+// Loads assets in two steps: the work step (file I/O, decoding) runs on worker
+// threads, and the finish step (anything that touches the engine or the GPU) runs
+// on the main thread, from Update. Finish steps run in the order the assets were
+// requested, so an asset may use the ones requested before it.
+//
+// Every Load returns a std::shared_future that's ready once the asset is finished.
+// Load and Update must only be called from the main thread.
+class AssetLoader {
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    AssetLoader(const std::string& base_path, const LoadingOptions& options)
+        : base_path_(base_path)
+        , synchronous_(options.synchronous || options.threads == 0)
+        , next_finish_(0)
+        , stopping_(false)
+        , start_(Clock::now())
+        , done_time_(start_)
+    {
+        if (!options.pack_path.empty()) {
+            pack_ = std::make_shared<AssetPack>(options.pack_path);
+            if (!pack_->is_open())
+                pack_.reset();
+        }
+        if (!synchronous_)
+            for (unsigned i = 0; i < options.threads; ++i)
+                workers_.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ~AssetLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Calls work() on a worker thread and then finish(result of work) on the main
+    // thread. The future holds what finish returns.
+    template<typename Work, typename Finish>
+    std::shared_future<typename std::result_of<Finish(typename std::result_of<Work()>::type&)>::type>
+    Load(const std::string& name, Work work, Finish finish) {
+        typedef typename std::result_of<Work()>::type Data;
+        typedef typename std::result_of<Finish(Data&)>::type Result;
+
+        auto data = std::make_shared<Data>();
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::shared_future<Result> future = promise->get_future().share();
+
+        auto job = std::make_shared<Job>();
+        job->name = name;
+        job->work = [data, work] { *data = work(); };
+        job->finish = [data, finish, promise] { promise->set_value(finish(*data)); };
+        jobs_.push_back(job);
+
+        if (synchronous_) {
+            job->work();
+            job->ready.store(true, std::memory_order_release);
+            Update(-1.0);
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.push_back(job);
+            }
+            condition_.notify_one();
+        }
+        return future;
+    }
+
+    // Reads a whole file, relative to the base path, or copies it out of the pack.
+    std::shared_future<std::string> LoadFile(const std::string& path) {
+        return Load(path, [this, path] { return Read(path); },
+                    [](std::string& contents) { return std::move(contents); });
+    }
+
+    // What LoadFile loads, read right away. Safe to call from work steps.
+    std::string Read(const std::string& path) const {
+        AssetView view = pack_ ? pack_->Get(path) : AssetView();
+        return view.found() ? view.str() : ReadFile(base_path_ + path);
+    }
+
+    // Like LoadFile, but files in the pack aren't copied: the view points into its
+    // mapping. Views are valid for as long as the loader.
+    std::shared_future<AssetView> LoadView(const std::string& path) {
+        std::string full_path = base_path_ + path;
+        std::shared_ptr<AssetPack> pack = pack_;
+        return Load(path, [full_path, path, pack] {
+                        AssetView view = pack ? pack->Get(path) : AssetView();
+                        std::shared_ptr<std::string> contents;
+                        if (!view.found()) {
+                            contents = std::make_shared<std::string>(ReadFile(full_path));
+                            view = AssetView(contents->data(), contents->size());
+                        }
+                        return std::make_pair(view, contents);
+                    },
+                    [this](std::pair<AssetView, std::shared_ptr<std::string>>& loaded) {
+                        if (loaded.second)
+                            loose_files_.push_back(loaded.second);
+                        return loaded.first;
+                    });
+    }
+
+    // text::manager() only loads fonts from a path, and their atlas is a GL texture,
+    // so all of it runs in the finish step, on the main thread. Fonts that should be
+    // rasterized on a worker go through examples::LoadAtlasFont instead.
+    std::shared_future<ugdk::text::Font*> LoadFont(const std::string& name, const std::string& path, double size) {
+        return Load(path, [] { return 0; },
+                    [name, path, size](int) {
+                        MemoryTagScope tag(MemoryTag::TEXT);
+                        return ugdk::text::manager()->AddFont(name, path, size);
+                    });
+    }
+
+    // Needs the font to be requested first. Like LoadFont, it all runs on the main
+    // thread, since GetTextFromFile reads the file itself.
+    std::shared_future<std::shared_ptr<ugdk::text::TextBox>> LoadTextBox(const std::string& path, const std::string& font_name) {
+        return Load(path, [] { return 0; },
+                    [path, font_name](int) {
+                        MemoryTagScope tag(MemoryTag::TEXT);
+                        return std::shared_ptr<ugdk::text::TextBox>(ugdk::text::manager()->GetTextFromFile(path, font_name));
+                    });
+    }
+
+    // Runs the finish step of the assets whose work is done, in order, until
+    // budget_ms is spent. At least one is finished per call; a negative budget
+    // finishes every one that's ready.
+    void Update(double budget_ms) {
+        Clock::time_point begin = Clock::now();
+        while (next_finish_ < jobs_.size()) {
+            Job& job = *jobs_[next_finish_];
+            if (!job.ready.load(std::memory_order_acquire))
+                break;
+            job.finish();
+            job.work = nullptr;
+            job.finish = nullptr;
+            if (++next_finish_ == jobs_.size())
+                done_time_ = Clock::now();
+            if (budget_ms >= 0.0 && Milliseconds(begin, Clock::now()) >= budget_ms)
+                break;
+        }
+    }
+
+    bool done() const { return next_finish_ == jobs_.size(); }
+    bool synchronous() const { return synchronous_; }
+    std::size_t num_requested() const { return jobs_.size(); }
+    std::size_t num_finished() const { return next_finish_; }
+    double progress() const { return jobs_.empty() ? 1.0 : next_finish_ / static_cast<double>(jobs_.size()); }
+
+    // Name of the next asset to be finished, or an empty string when done.
+    const std::string& current() const {
+        static const std::string empty;
+        return done() ? empty : jobs_[next_finish_]->name;
+    }
+
+    // Time from the construction of the loader until the last asset was finished.
+    double loading_ms() const { return Milliseconds(start_, done() ? done_time_ : Clock::now()); }
+
+  private:
+    struct Job {
+        Job() : ready(false) {}
+        std::string name;
+        std::function<void ()> work, finish;
+        std::atomic<bool> ready;
+    };
+
+    static std::string ReadFile(const std::string& path) {
+        MemoryTagScope tag(MemoryTag::FILESYSTEM);
+        std::ifstream file(path, std::ios::in | std::ios::binary);
+        if (!file) {
+            std::fprintf(stderr, "Unable to open '%s'.\n", path.c_str());
+            return std::string();
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    void WorkerLoop() {
+        for (;;) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this] { return stopping_ || !pending_.empty(); });
+                if (stopping_)
+                    return;
+                job = pending_.front();
+                pending_.pop_front();
+            }
+            job->work();
+            job->ready.store(true, std::memory_order_release);
+        }
+    }
+
+    std::string base_path_;
+    bool synchronous_;
+    std::shared_ptr<AssetPack> pack_;
+    // Contents of the views of files that weren't in the pack.
+    std::vector<std::shared_ptr<std::string>> loose_files_;
+
+    // Main thread only.
+    std::vector<std::shared_ptr<Job>> jobs_;
+    std::size_t next_finish_;
+
+    // Shared with the workers.
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<std::shared_ptr<Job>> pending_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+
+    Clock::time_point start_, done_time_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_ASSETLOADER_H_
@@ -0,0 +1,362 @@
+#ifndef UGDK_EXAMPLES_ASSETPACK_H_
+#define UGDK_EXAMPLES_ASSETPACK_H_
+
+#include <examples/mappedfile.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// Pack files hold many assets behind one sorted index, so finding an asset is a
+// binary search and reading it is a pointer into a single memory mapping.
+//
+// Layout, in the byte order of the machine that wrote it:
+//   PackHeader
+//   PackEntry[num_entries]   sorted by path
+//   paths                    concatenated, not null-terminated
+//   data                     each entry 16-byte aligned
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t num_entries;
+};
+static_assert(sizeof(PackHeader) == 16, "PackHeader must be tightly packed.");
+
+struct PackEntry {
+    enum Compression { STORED = 0, LZ = 1 };
+
+    uint64_t offset;       // Of the data, from the start of the file.
+    uint64_t stored_size;  // Bytes in the file.
+    uint64_t size;         // Bytes once decompressed.
+    uint32_t path_offset;  // From the start of the paths.
+    uint16_t path_length;
+    uint8_t compression;
+    uint8_t padding;
+};
+static_assert(sizeof(PackEntry) == 32, "PackEntry must be tightly packed.");
+
+const char ASSET_PACK_MAGIC[8] = { 'U', 'G', 'D', 'K', 'P', 'A', 'C', 'K' };
+const uint32_t ASSET_PACK_VERSION = 1;
+
+// A small LZ77 compressor, in the spirit of LZ4: fast to decode and good enough
+// for text and uncompressed binary formats. Each sequence is a token whose high
+// nibble is the literal count and low nibble the match length minus 4, with 15
+// meaning more length bytes follow; then the literals, then a 2-byte offset and
+// the match. The last sequence has only literals.
+namespace lz {
+    const std::size_t MIN_MATCH = 4;
+    const std::size_t MAX_OFFSET = 65535;
+
+    inline void PutLength(std::string& out, std::size_t length) {
+        for (; length >= 255; length -= 255)
+            out += static_cast<char>(255);
+        out += static_cast<char>(length);
+    }
+
+    inline void PutSequence(std::string& out, const char* literals, std::size_t num_literals,
+                            std::size_t offset, std::size_t match_length) {
+        std::size_t match_code = match_length ? match_length - MIN_MATCH : 0;
+        out += static_cast<char>(std::min<std::size_t>(num_literals, 15) << 4 | std::min<std::size_t>(match_code, 15));
+        if (num_literals >= 15)
+            PutLength(out, num_literals - 15);
+        out.append(literals, num_literals);
+        if (match_length == 0)
+            return;
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>(offset >> 8);
+        if (match_code >= 15)
+            PutLength(out, match_code - 15);
+    }
+
+    inline std::string Compress(const char* src, std::size_t size) {
+        const int HASH_BITS = 14;
+        const std::size_t NONE = static_cast<std::size_t>(-1);
+        std::vector<std::size_t> table(std::size_t(1) << HASH_BITS, NONE);
+        std::string out;
+        out.reserve(size / 2 + 16);
+        std::size_t anchor = 0, i = 0;
+        while (i + MIN_MATCH <= size) {
+            uint32_t sequence;
+            std::memcpy(&sequence, src + i, 4);
+            std::size_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+            std::size_t candidate = table[hash];
+            table[hash] = i;
+            if (candidate == NONE || i - candidate > MAX_OFFSET || std::memcmp(src + candidate, src + i, MIN_MATCH) != 0) {
+                ++i;
+                continue;
+            }
+            std::size_t length = MIN_MATCH;
+            while (i + length < size && src[candidate + length] == src[i + length])
+                ++length;
+            PutSequence(out, src + anchor, i - anchor, i - candidate, length);
+            i += length;
+            anchor = i;
+        }
+        PutSequence(out, src + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    // Returns false if src is malformed or doesn't decompress to exactly size bytes.
+    inline bool Decompress(const char* src, std::size_t src_size, char* dst, std::size_t size) {
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* in_end = in + src_size;
+        std::size_t out = 0;
+        auto get_length = [&in, in_end](std::size_t& length) {
+            for (;;) {
+                if (in == in_end)
+                    return false;
+                uint8_t byte = *in++;
+                length += byte;
+                if (byte != 255)
+                    return true;
+            }
+        };
+        while (in < in_end) {
+            uint8_t token = *in++;
+            std::size_t num_literals = token >> 4;
+            if (num_literals == 15 && !get_length(num_literals))
+                return false;
+            if (num_literals > static_cast<std::size_t>(in_end - in) || num_literals > size - out)
+                return false;
+            std::memcpy(dst + out, in, num_literals);
+            in += num_literals;
+            out += num_literals;
+            if (in == in_end)
+                break;
+            if (in_end - in < 2)
+                return false;
+            std::size_t offset = in[0] | in[1] << 8;
+            in += 2;
+            std::size_t length = token & 0xF;
+            if (length == 15 && !get_length(length))
+                return false;
+            length += MIN_MATCH;
+            if (offset == 0 || offset > out || length > size - out)
+                return false;
+            // Byte by byte, since the match may overlap what it's copying.
+            for (std::size_t k = 0; k < length; ++k, ++out)
+                dst[out] = dst[out - offset];
+        }
+        return out == size;
+    }
+}
+
+// Contents of an asset, valid as long as the pack it came from.
+struct AssetView {
+    AssetView() : data(nullptr), size(0) {}
+    AssetView(const char* data, std::size_t size) : data(data), size(size) {}
+
+    bool found() const { return data != nullptr; }
+    std::string str() const { return std::string(data, size); }
+
+    const char* data;
+    std::size_t size;
+};
+
+// Read-only access to a pack file through one memory mapping.
+//
+// Stored entries are returned as views into the mapping, with no copy. Compressed
+// entries are decompressed the first time they're read and kept for the lifetime
+// of the pack. Get may be called from any thread.
+class AssetPack {
+  public:
+    AssetPack() : entries_(nullptr), num_entries_(0), paths_(nullptr) {}
+
+    explicit AssetPack(const std::string& path) : AssetPack() {
+        Open(path);
+    }
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Returns false, printing why, if the file isn't a valid pack.
+    bool Open(const std::string& path) {
+        entries_ = nullptr;
+        num_entries_ = 0;
+        decompressed_.clear();
+        if (!file_.Open(path)) {
+            std::fprintf(stderr, "Unable to open the asset pack '%s'.\n", path.c_str());
+            return false;
+        }
+        PackHeader header;
+        bool valid = file_.size() >= sizeof(header);
+        if (valid) {
+            std::memcpy(&header, file_.data(), sizeof(header));
+            valid = std::memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) == 0
+                && header.version == ASSET_PACK_VERSION
+                && file_.size() >= sizeof(header) + header.num_entries * sizeof(PackEntry);
+        }
+        if (valid) {
+            const PackEntry* entries = reinterpret_cast<const PackEntry*>(file_.data() + sizeof(header));
+            std::size_t paths_begin = sizeof(header) + header.num_entries * sizeof(PackEntry);
+            // Written so that no sum of offsets and sizes from the file can overflow.
+            for (uint32_t i = 0; valid && i < header.num_entries; ++i)
+                valid = paths_begin + entries[i].path_offset + entries[i].path_length <= file_.size()
+                    && entries[i].offset <= file_.size() && entries[i].stored_size <= file_.size() - entries[i].offset
+                    && entries[i].compression <= PackEntry::LZ
+                    && (entries[i].compression != PackEntry::STORED || entries[i].size == entries[i].stored_size);
+            entries_ = entries;
+            num_entries_ = header.num_entries;
+            paths_ = file_.data() + paths_begin;
+        }
+        if (!valid) {
+            std::fprintf(stderr, "'%s' isn't a valid asset pack.\n", path.c_str());
+            file_.Close();
+            entries_ = nullptr;
+            num_entries_ = 0;
+            return false;
+        }
+        decompressed_.resize(num_entries_);
+        return true;
+    }
+
+    bool is_open() const { return entries_ != nullptr; }
+    std::size_t num_entries() const { return num_entries_; }
+    const PackEntry& entry(std::size_t index) const { return entries_[index]; }
+
+    std::string path(std::size_t index) const {
+        return std::string(paths_ + entries_[index].path_offset, entries_[index].path_length);
+    }
+
+    // Index of the entry with this path, or num_entries() if there's none.
+    std::size_t Find(const std::string& path) const {
+        const PackEntry* end = entries_ + num_entries_;
+        const PackEntry* it = std::lower_bound(entries_, end, path, [this](const PackEntry& entry, const std::string& p) {
+            return Compare(entry, p) < 0;
+        });
+        return it != end && Compare(*it, path) == 0 ? static_cast<std::size_t>(it - entries_) : num_entries_;
+    }
+
+    // The contents of the entry with this path; not found() if there's none or it's corrupt.
+    AssetView Get(const std::string& path) {
+        std::size_t index = Find(path);
+        return index < num_entries_ ? Get(index) : AssetView();
+    }
+
+    AssetView Get(std::size_t index) {
+        const PackEntry& entry = entries_[index];
+        const char* data = file_.data() + entry.offset;
+        if (entry.compression == PackEntry::STORED)
+            return AssetView(data, static_cast<std::size_t>(entry.size));
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unique_ptr<std::vector<char>>& contents = decompressed_[index];
+        if (!contents) {
+            std::unique_ptr<std::vector<char>> buffer(new std::vector<char>(static_cast<std::size_t>(entry.size) + 1));
+            if (!lz::Decompress(data, static_cast<std::size_t>(entry.stored_size), buffer->data(), static_cast<std::size_t>(entry.size))) {
+                std::fprintf(stderr, "Asset '%s' is corrupt.\n", path(index).c_str());
+                return AssetView();
+            }
+            contents = std::move(buffer);
+        }
+        return AssetView(contents->data(), static_cast<std::size_t>(entry.size));
+    }
+
+  private:
+    int Compare(const PackEntry& entry, const std::string& path) const {
+        std::size_t length = std::min<std::size_t>(entry.path_length, path.size());
+        int result = std::memcmp(paths_ + entry.path_offset, path.data(), length);
+        if (result != 0)
+            return result;
+        return entry.path_length < path.size() ? -1 : entry.path_length > path.size() ? 1 : 0;
+    }
+
+    MappedFile file_;
+    const PackEntry* entries_;
+    std::size_t num_entries_;
+    const char* paths_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<std::vector<char>>> decompressed_;
+};
+
+// Builds a pack file. Used by the asset-pack tool.
+class AssetPackWriter {
+  public:
+    // Compressed entries that don't shrink are stored instead.
+    void Add(const std::string& path, const std::string& contents, bool compress) {
+        Item item = { path, contents, PackEntry::STORED, contents.size() };
+        if (compress && !contents.empty()) {
+            std::string compressed = lz::Compress(contents.data(), contents.size());
+            if (compressed.size() < contents.size()) {
+                item.stored = std::move(compressed);
+                item.compression = PackEntry::LZ;
+            }
+        }
+        items_.push_back(std::move(item));
+    }
+
+    std::size_t size() const { return items_.size(); }
+
+    // Returns false, printing why, on duplicate paths or write errors.
+    bool Write(const std::string& output_path) {
+        std::sort(items_.begin(), items_.end(), [](const Item& a, const Item& b) { return a.path < b.path; });
+        for (std::size_t i = 1; i < items_.size(); ++i)
+            if (items_[i].path == items_[i - 1].path) {
+                std::fprintf(stderr, "'%s' was added twice.\n", items_[i].path.c_str());
+                return false;
+            }
+
+        PackHeader header;
+        std::memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+        header.version = ASSET_PACK_VERSION;
+        header.num_entries = static_cast<uint32_t>(items_.size());
+
+        std::string paths;
+        std::vector<PackEntry> entries(items_.size());
+        for (std::size_t i = 0; i < items_.size(); ++i) {
+            entries[i].path_offset = static_cast<uint32_t>(paths.size());
+            entries[i].path_length = static_cast<uint16_t>(items_[i].path.size());
+            entries[i].compression = static_cast<uint8_t>(items_[i].compression);
+            entries[i].padding = 0;
+            entries[i].stored_size = items_[i].stored.size();
+            entries[i].size = items_[i].size;
+            paths += items_[i].path;
+        }
+        uint64_t offset = sizeof(header) + entries.size() * sizeof(PackEntry) + paths.size();
+        for (PackEntry& entry : entries) {
+            offset = (offset + 15) & ~uint64_t(15);
+            entry.offset = offset;
+            offset += entry.stored_size;
+        }
+
+        FILE* out = std::fopen(output_path.c_str(), "wb");
+        if (!out) {
+            std::fprintf(stderr, "Unable to open '%s' for writing.\n", output_path.c_str());
+            return false;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1
+            && (entries.empty() || std::fwrite(entries.data(), sizeof(PackEntry), entries.size(), out) == entries.size())
+            && std::fwrite(paths.data(), 1, paths.size(), out) == paths.size();
+        uint64_t position = sizeof(header) + entries.size() * sizeof(PackEntry) + paths.size();
+        static const char zeros[16] = {};
+        for (std::size_t i = 0; ok && i < items_.size(); ++i) {
+            ok = std::fwrite(zeros, 1, static_cast<std::size_t>(entries[i].offset - position), out) == entries[i].offset - position
+                && std::fwrite(items_[i].stored.data(), 1, items_[i].stored.size(), out) == items_[i].stored.size();
+            position = entries[i].offset + entries[i].stored_size;
+        }
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok)
+            std::fprintf(stderr, "Unable to write '%s'.\n", output_path.c_str());
+        return ok;
+    }
+
+  private:
+    struct Item {
+        std::string path;
+        std::string stored;
+        PackEntry::Compression compression;
+        uint64_t size;
+    };
+
+    std::vector<Item> items_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_ASSETPACK_H_
@@ -0,0 +1,160 @@
+#ifndef UGDK_EXAMPLES_ATLASTEXT_H_
+#define UGDK_EXAMPLES_ATLASTEXT_H_
+
+#include <ugdk/graphic/gltexture.h>
+#include <ugdk/graphic/opengl.h>
+#include <ugdk/math/vector2D.h>
+#include <ugdk/structure/color.h>
+
+#include <examples/assetloader.h>
+#include <examples/glyphcache.h>
+#include <examples/quadbatch.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// A GlyphAtlas uploaded to a texture, that queues text into a QuadBatch as one quad
+// per glyph. All the text of one AtlasFont shares that texture, so any amount of it
+// queued in a batch takes a single draw call, where every text::Label takes its own.
+//
+// Text is read byte by byte, so only characters below 128 show. The texture goes
+// with the AtlasFont, which must be destroyed before the graphic module is.
+class AtlasFont {
+  public:
+    // Uploads atlas, white with the glyph coverage as alpha. Main thread only.
+    explicit AtlasFont(std::unique_ptr<GlyphAtlas> atlas)
+        : atlas_(std::move(atlas))
+        , ascent_(0)
+    {
+        std::fill(glyphs_, glyphs_ + 128, nullptr);
+        for (std::size_t i = 0; i < atlas_->num_glyphs(); ++i) {
+            const GlyphMetrics& glyph = atlas_->glyphs()[i];
+            if (glyph.codepoint < 128)
+                glyphs_[glyph.codepoint] = &glyph;
+            ascent_ = std::max(ascent_, static_cast<int>(glyph.bearing_y));
+        }
+        Upload();
+    }
+
+    const GlyphAtlas& atlas() const { return *atlas_; }
+    const ugdk::graphic::GLTexture* texture() const { return texture_.get(); }
+    double line_height() const { return atlas_->line_height(); }
+    // From the top of a line to its baseline, in pixels.
+    int ascent() const { return ascent_; }
+
+    // The glyph of c, or null when the atlas has none.
+    const GlyphMetrics* glyph(char c) const {
+        return static_cast<unsigned char>(c) < 128 ? glyphs_[static_cast<int>(c)] : nullptr;
+    }
+
+    // The part of the texture that shows glyph.
+    TextureRegion Region(const GlyphMetrics& glyph) const {
+        double inverse_width = 1.0 / atlas_->width(), inverse_height = 1.0 / atlas_->height();
+        TextureRegion region = {
+            static_cast<float>(glyph.x * inverse_width), static_cast<float>(glyph.y * inverse_height),
+            static_cast<float>((glyph.x + glyph.width) * inverse_width),
+            static_cast<float>((glyph.y + glyph.height) * inverse_height)
+        };
+        return region;
+    }
+
+    // Width of text and height of its line, in pixels.
+    ugdk::math::Vector2D Measure(const char* text, std::size_t length) const {
+        int width = 0;
+        for (std::size_t i = 0; i < length; ++i)
+            if (const GlyphMetrics* metrics = glyph(text[i]))
+                width += metrics->advance;
+        return ugdk::math::Vector2D(width, line_height());
+    }
+
+    // Queues text so that the point align of its box, from (0, 0) for the top-left
+    // corner to (1, 1) for the bottom-right one, lands on position.
+    void AddText(QuadBatch& batch, const char* text, std::size_t length, const ugdk::math::Vector2D& position,
+                 const ugdk::Color& color, const ugdk::math::Vector2D& align = ugdk::math::Vector2D()) const {
+        ugdk::math::Vector2D origin = position;
+        if (align.x != 0.0 || align.y != 0.0)
+            origin = origin - Measure(text, length).Scale(align);
+        double pen_x = origin.x, baseline = origin.y + ascent_;
+        for (std::size_t i = 0; i < length; ++i) {
+            const GlyphMetrics* metrics = glyph(text[i]);
+            if (!metrics)
+                continue;
+            if (metrics->width > 0 && metrics->height > 0)
+                batch.Add(texture_.get(), ugdk::math::Vector2D(pen_x + metrics->bearing_x, baseline - metrics->bearing_y),
+                          ugdk::math::Vector2D(metrics->width, metrics->height), color, Region(*metrics));
+            pen_x += metrics->advance;
+        }
+    }
+
+    void AddText(QuadBatch& batch, const std::string& text, const ugdk::math::Vector2D& position,
+                 const ugdk::Color& color, const ugdk::math::Vector2D& align = ugdk::math::Vector2D()) const {
+        AddText(batch, text.data(), text.size(), position, color, align);
+    }
+
+  private:
+    void Upload() {
+        int width = atlas_->width(), height = atlas_->height();
+        std::vector<uint8_t> rgba(static_cast<std::size_t>(width) * height * 4, 255);
+        const uint8_t* coverage = atlas_->pixels();
+        for (std::size_t i = 0; i < static_cast<std::size_t>(width) * height; ++i)
+            rgba[4 * i + 3] = coverage[i];
+        texture_.reset(ugdk::graphic::GLTexture::CreateRawTexture(width, height));
+        glBindTexture(GL_TEXTURE_2D, texture_->id());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    }
+
+    std::unique_ptr<GlyphAtlas> atlas_;
+    std::unique_ptr<ugdk::graphic::GLTexture> texture_;
+    const GlyphMetrics* glyphs_[128];
+    int ascent_;
+};
+
+// Printable ASCII, the characters AtlasFont can show.
+inline std::vector<uint32_t> AsciiCodepoints() {
+    std::vector<uint32_t> codepoints;
+    for (uint32_t c = ' '; c <= '~'; ++c)
+        codepoints.push_back(c);
+    return codepoints;
+}
+
+// Reads the font and rasterizes its glyphs on one of loader's workers, then uploads
+// the atlas on the main thread. The future holds null if the font can't be read.
+//
+// With a cache, the atlas is mapped from it when it was rasterized before, and
+// written to it otherwise. The cache must outlive the load and not be used by
+// anything else until then.
+inline std::shared_future<std::shared_ptr<AtlasFont>> LoadAtlasFont(AssetLoader& loader, const std::string& path,
+                                                                    int pixel_size, const std::vector<uint32_t>& codepoints,
+                                                                    GlyphCache* cache = nullptr) {
+    AssetLoader* source = &loader;
+    return loader.Load(path, [source, path, pixel_size, codepoints, cache] {
+                           std::string font = source->Read(path);
+                           MemoryTagScope tag(MemoryTag::TEXT);
+                           if (font.empty())
+                               return std::unique_ptr<GlyphAtlas>();
+                           if (cache)
+                               return cache->Load(font.data(), font.size(), pixel_size, codepoints);
+                           return GlyphCache::Rasterize(font.data(), font.size(), pixel_size, codepoints);
+                       },
+                       [path](std::unique_ptr<GlyphAtlas>& atlas) {
+                           MemoryTagScope tag(MemoryTag::TEXT);
+                           if (!atlas) {
+                               std::fprintf(stderr, "Unable to rasterize '%s'.\n", path.c_str());
+                               return std::shared_ptr<AtlasFont>();
+                           }
+                           return std::make_shared<AtlasFont>(std::move(atlas));
+                       });
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_ATLASTEXT_H_
@@ -0,0 +1,255 @@
+#ifndef UGDK_EXAMPLES_BATCHTRANSFORM_H_
+#define UGDK_EXAMPLES_BATCHTRANSFORM_H_
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// The SSE and AVX paths are compiled with target attributes, so they don't need
+// -mavx, and only run when the CPU supports them.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define EXAMPLES_BATCHTRANSFORM_X86
+#include <immintrin.h>
+#endif
+
+namespace examples {
+
+// 2D affine transform: x' = a*x + c*y + tx, y' = b*x + d*y + ty.
+struct Affine2D {
+    Affine2D() : a(1.0), b(0.0), c(0.0), d(1.0), tx(0.0), ty(0.0) {}
+
+    static Affine2D Translation(double x, double y) {
+        Affine2D result;
+        result.tx = x;
+        result.ty = y;
+        return result;
+    }
+
+    // The transform that applies other first and then this.
+    Affine2D operator*(const Affine2D& other) const {
+        Affine2D result;
+        result.a  = a * other.a  + c * other.b;
+        result.b  = b * other.a  + d * other.b;
+        result.c  = a * other.c  + c * other.d;
+        result.d  = b * other.c  + d * other.d;
+        result.tx = a * other.tx + c * other.ty + tx;
+        result.ty = b * other.tx + d * other.ty + ty;
+        return result;
+    }
+
+    double a, b, c, d, tx, ty;
+};
+
+// Offsets, scales and rotations of many children of the same parent, one array
+// each. Rotations are kept as their cosine and sine, so transforming a batch needs
+// no trigonometry. Real is double, like math::Vector2D, or float, like the
+// vertices the positions end up in.
+template<typename Real>
+struct TransformBatch {
+    std::vector<Real> x, y;
+    std::vector<Real> scale_x, scale_y;
+    std::vector<Real> cos, sin;
+
+    std::size_t size() const { return x.size(); }
+
+    void resize(std::size_t count) {
+        x.resize(count);
+        y.resize(count);
+        scale_x.resize(count, Real(1));
+        scale_y.resize(count, Real(1));
+        cos.resize(count, Real(1));
+        sin.resize(count, Real(0));
+    }
+
+    void Set(std::size_t i, double offset_x, double offset_y, double sx, double sy, double rotation) {
+        x[i] = static_cast<Real>(offset_x);
+        y[i] = static_cast<Real>(offset_y);
+        scale_x[i] = static_cast<Real>(sx);
+        scale_y[i] = static_cast<Real>(sy);
+        cos[i] = static_cast<Real>(std::cos(rotation));
+        sin[i] = static_cast<Real>(std::sin(rotation));
+    }
+};
+
+enum class BatchPath { SCALAR, SSE, AVX };
+
+inline const char* BatchPathName(BatchPath path) {
+    switch (path) {
+    case BatchPath::SSE: return "sse";
+    case BatchPath::AVX: return "avx";
+    default: return "scalar";
+    }
+}
+
+inline bool BatchPathSupported(BatchPath path) {
+#ifdef EXAMPLES_BATCHTRANSFORM_X86
+    __builtin_cpu_init();
+    if (path == BatchPath::SSE)
+        return __builtin_cpu_supports("sse2");
+    if (path == BatchPath::AVX)
+        return __builtin_cpu_supports("avx");
+#endif
+    return path == BatchPath::SCALAR;
+}
+
+inline BatchPath BestBatchPath() {
+    static const BatchPath best = BatchPathSupported(BatchPath::AVX) ? BatchPath::AVX
+                                : BatchPathSupported(BatchPath::SSE) ? BatchPath::SSE
+                                : BatchPath::SCALAR;
+    return best;
+}
+
+namespace internal {
+    // Quads [begin, end): each child's transform is Translation(x, y) * Rotation *
+    // Scale, composed with parent, and its quad is (0, 0)-(width, height) in child
+    // space. The 4 corners go to out[8 * i], clockwise from the origin, as x, y pairs.
+    template<typename Real>
+    void TransformQuadsScalar(const Affine2D& parent, const TransformBatch<Real>& batch, Real width, Real height,
+                              Real* out, std::size_t begin, std::size_t end) {
+        const Real pa = static_cast<Real>(parent.a), pb = static_cast<Real>(parent.b);
+        const Real pc = static_cast<Real>(parent.c), pd = static_cast<Real>(parent.d);
+        const Real ptx = static_cast<Real>(parent.tx), pty = static_cast<Real>(parent.ty);
+        for (std::size_t i = begin; i < end; ++i) {
+            Real sxc = batch.scale_x[i] * batch.cos[i], sxs = batch.scale_x[i] * batch.sin[i];
+            Real syc = batch.scale_y[i] * batch.cos[i], sys = batch.scale_y[i] * batch.sin[i];
+            Real wa = width * (pa * sxc + pc * sxs), wb = width * (pb * sxc + pd * sxs);
+            Real hc = height * (pc * syc - pa * sys), hd = height * (pd * syc - pb * sys);
+            Real tx = pa * batch.x[i] + pc * batch.y[i] + ptx;
+            Real ty = pb * batch.x[i] + pd * batch.y[i] + pty;
+            Real* v = out + 8 * i;
+            v[0] = tx;
+            v[1] = ty;
+            v[2] = tx + wa;
+            v[3] = ty + wb;
+            v[4] = tx + wa + hc;
+            v[5] = ty + wb + hd;
+            v[6] = tx + hc;
+            v[7] = ty + hd;
+        }
+    }
+
+#ifdef EXAMPLES_BATCHTRANSFORM_X86
+    // Four quads per iteration, then the scalar path for the rest.
+    __attribute__((target("sse2")))
+    inline void TransformQuadsSSE(const Affine2D& parent, const TransformBatch<float>& batch, float width, float height,
+                                  float* out) {
+        const __m128 pa = _mm_set1_ps(static_cast<float>(parent.a)), pb = _mm_set1_ps(static_cast<float>(parent.b));
+        const __m128 pc = _mm_set1_ps(static_cast<float>(parent.c)), pd = _mm_set1_ps(static_cast<float>(parent.d));
+        const __m128 ptx = _mm_set1_ps(static_cast<float>(parent.tx)), pty = _mm_set1_ps(static_cast<float>(parent.ty));
+        const __m128 w = _mm_set1_ps(width), h = _mm_set1_ps(height);
+        std::size_t count = batch.size(), i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 sx = _mm_loadu_ps(&batch.scale_x[i]), sy = _mm_loadu_ps(&batch.scale_y[i]);
+            __m128 co = _mm_loadu_ps(&batch.cos[i]), si = _mm_loadu_ps(&batch.sin[i]);
+            __m128 x = _mm_loadu_ps(&batch.x[i]), y = _mm_loadu_ps(&batch.y[i]);
+            __m128 sxc = _mm_mul_ps(sx, co), sxs = _mm_mul_ps(sx, si);
+            __m128 syc = _mm_mul_ps(sy, co), sys = _mm_mul_ps(sy, si);
+            __m128 wa = _mm_mul_ps(w, _mm_add_ps(_mm_mul_ps(pa, sxc), _mm_mul_ps(pc, sxs)));
+            __m128 wb = _mm_mul_ps(w, _mm_add_ps(_mm_mul_ps(pb, sxc), _mm_mul_ps(pd, sxs)));
+            __m128 hc = _mm_mul_ps(h, _mm_sub_ps(_mm_mul_ps(pc, syc), _mm_mul_ps(pa, sys)));
+            __m128 hd = _mm_mul_ps(h, _mm_sub_ps(_mm_mul_ps(pd, syc), _mm_mul_ps(pb, sys)));
+            __m128 x0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pa, x), _mm_mul_ps(pc, y)), ptx);
+            __m128 y0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(pb, x), _mm_mul_ps(pd, y)), pty);
+            __m128 x1 = _mm_add_ps(x0, wa), y1 = _mm_add_ps(y0, wb);
+            __m128 x2 = _mm_add_ps(x1, hc), y2 = _mm_add_ps(y1, hd);
+            __m128 x3 = _mm_add_ps(x0, hc), y3 = _mm_add_ps(y0, hd);
+
+            // From one register per coordinate to x, y pairs: lo_k holds corner k of
+            // quads 0 and 1, hi_k of quads 2 and 3.
+            __m128 lo0 = _mm_unpacklo_ps(x0, y0), hi0 = _mm_unpackhi_ps(x0, y0);
+            __m128 lo1 = _mm_unpacklo_ps(x1, y1), hi1 = _mm_unpackhi_ps(x1, y1);
+            __m128 lo2 = _mm_unpacklo_ps(x2, y2), hi2 = _mm_unpackhi_ps(x2, y2);
+            __m128 lo3 = _mm_unpacklo_ps(x3, y3), hi3 = _mm_unpackhi_ps(x3, y3);
+            float* v = out + 8 * i;
+            _mm_storeu_ps(v, _mm_movelh_ps(lo0, lo1));
+            _mm_storeu_ps(v + 4, _mm_movelh_ps(lo2, lo3));
+            _mm_storeu_ps(v + 8, _mm_movehl_ps(lo1, lo0));
+            _mm_storeu_ps(v + 12, _mm_movehl_ps(lo3, lo2));
+            _mm_storeu_ps(v + 16, _mm_movelh_ps(hi0, hi1));
+            _mm_storeu_ps(v + 20, _mm_movelh_ps(hi2, hi3));
+            _mm_storeu_ps(v + 24, _mm_movehl_ps(hi1, hi0));
+            _mm_storeu_ps(v + 28, _mm_movehl_ps(hi3, hi2));
+        }
+        TransformQuadsScalar(parent, batch, width, height, out, i, count);
+    }
+
+    // Eight quads per iteration. AVX shuffles stay within 128-bit halves, so the
+    // low half works on quads 0 to 3 and the high half on quads 4 to 7.
+    __attribute__((target("avx")))
+    inline void TransformQuadsAVX(const Affine2D& parent, const TransformBatch<float>& batch, float width, float height,
+                                  float* out) {
+        const __m256 pa = _mm256_set1_ps(static_cast<float>(parent.a)), pb = _mm256_set1_ps(static_cast<float>(parent.b));
+        const __m256 pc = _mm256_set1_ps(static_cast<float>(parent.c)), pd = _mm256_set1_ps(static_cast<float>(parent.d));
+        const __m256 ptx = _mm256_set1_ps(static_cast<float>(parent.tx)), pty = _mm256_set1_ps(static_cast<float>(parent.ty));
+        const __m256 w = _mm256_set1_ps(width), h = _mm256_set1_ps(height);
+        std::size_t count = batch.size(), i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 sx = _mm256_loadu_ps(&batch.scale_x[i]), sy = _mm256_loadu_ps(&batch.scale_y[i]);
+            __m256 co = _mm256_loadu_ps(&batch.cos[i]), si = _mm256_loadu_ps(&batch.sin[i]);
+            __m256 x = _mm256_loadu_ps(&batch.x[i]), y = _mm256_loadu_ps(&batch.y[i]);
+            __m256 sxc = _mm256_mul_ps(sx, co), sxs = _mm256_mul_ps(sx, si);
+            __m256 syc = _mm256_mul_ps(sy, co), sys = _mm256_mul_ps(sy, si);
+            __m256 wa = _mm256_mul_ps(w, _mm256_add_ps(_mm256_mul_ps(pa, sxc), _mm256_mul_ps(pc, sxs)));
+            __m256 wb = _mm256_mul_ps(w, _mm256_add_ps(_mm256_mul_ps(pb, sxc), _mm256_mul_ps(pd, sxs)));
+            __m256 hc = _mm256_mul_ps(h, _mm256_sub_ps(_mm256_mul_ps(pc, syc), _mm256_mul_ps(pa, sys)));
+            __m256 hd = _mm256_mul_ps(h, _mm256_sub_ps(_mm256_mul_ps(pd, syc), _mm256_mul_ps(pb, sys)));
+            __m256 x0 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pa, x), _mm256_mul_ps(pc, y)), ptx);
+            __m256 y0 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(pb, x), _mm256_mul_ps(pd, y)), pty);
+            __m256 x1 = _mm256_add_ps(x0, wa), y1 = _mm256_add_ps(y0, wb);
+            __m256 x2 = _mm256_add_ps(x1, hc), y2 = _mm256_add_ps(y1, hd);
+            __m256 x3 = _mm256_add_ps(x0, hc), y3 = _mm256_add_ps(y0, hd);
+
+            // lo_k holds corner k of quads 0, 1 | 4, 5 and hi_k of quads 2, 3 | 6, 7.
+            __m256 lo0 = _mm256_unpacklo_ps(x0, y0), hi0 = _mm256_unpackhi_ps(x0, y0);
+            __m256 lo1 = _mm256_unpacklo_ps(x1, y1), hi1 = _mm256_unpackhi_ps(x1, y1);
+            __m256 lo2 = _mm256_unpacklo_ps(x2, y2), hi2 = _mm256_unpackhi_ps(x2, y2);
+            __m256 lo3 = _mm256_unpacklo_ps(x3, y3), hi3 = _mm256_unpackhi_ps(x3, y3);
+            // Corners 0, 1 and corners 2, 3 of quads q | q + 4.
+            __m256 q0a = _mm256_shuffle_ps(lo0, lo1, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 q0b = _mm256_shuffle_ps(lo2, lo3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 q1a = _mm256_shuffle_ps(lo0, lo1, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 q1b = _mm256_shuffle_ps(lo2, lo3, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 q2a = _mm256_shuffle_ps(hi0, hi1, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 q2b = _mm256_shuffle_ps(hi2, hi3, _MM_SHUFFLE(1, 0, 1, 0));
+            __m256 q3a = _mm256_shuffle_ps(hi0, hi1, _MM_SHUFFLE(3, 2, 3, 2));
+            __m256 q3b = _mm256_shuffle_ps(hi2, hi3, _MM_SHUFFLE(3, 2, 3, 2));
+            float* v = out + 8 * i;
+            _mm256_storeu_ps(v, _mm256_permute2f128_ps(q0a, q0b, 0x20));
+            _mm256_storeu_ps(v + 8, _mm256_permute2f128_ps(q1a, q1b, 0x20));
+            _mm256_storeu_ps(v + 16, _mm256_permute2f128_ps(q2a, q2b, 0x20));
+            _mm256_storeu_ps(v + 24, _mm256_permute2f128_ps(q3a, q3b, 0x20));
+            _mm256_storeu_ps(v + 32, _mm256_permute2f128_ps(q0a, q0b, 0x31));
+            _mm256_storeu_ps(v + 40, _mm256_permute2f128_ps(q1a, q1b, 0x31));
+            _mm256_storeu_ps(v + 48, _mm256_permute2f128_ps(q2a, q2b, 0x31));
+            _mm256_storeu_ps(v + 56, _mm256_permute2f128_ps(q3a, q3b, 0x31));
+        }
+        TransformQuadsScalar(parent, batch, width, height, out, i, count);
+    }
+#endif
+}
+
+// Composes parent with the transform of every child of batch and writes the 4
+// corners of each child's width x height quad to out, which must hold
+// 8 * batch.size() floats. Unsupported paths fall back to the scalar one.
+inline void TransformQuads(const Affine2D& parent, const TransformBatch<float>& batch, float width, float height,
+                           float* out, BatchPath path = BestBatchPath()) {
+#ifdef EXAMPLES_BATCHTRANSFORM_X86
+    if (path == BatchPath::AVX && BatchPathSupported(BatchPath::AVX))
+        return internal::TransformQuadsAVX(parent, batch, width, height, out);
+    if (path != BatchPath::SCALAR && BatchPathSupported(BatchPath::SSE))
+        return internal::TransformQuadsSSE(parent, batch, width, height, out);
+#else
+    (void) path;
+#endif
+    internal::TransformQuadsScalar(parent, batch, width, height, out, 0, batch.size());
+}
+
+// Double precision has only the scalar path, which the compiler may vectorize.
+inline void TransformQuads(const Affine2D& parent, const TransformBatch<double>& batch, double width, double height,
+                           double* out) {
+    internal::TransformQuadsScalar(parent, batch, width, height, out, 0, batch.size());
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_BATCHTRANSFORM_H_
@@ -0,0 +1,262 @@
+#ifndef UGDK_EXAMPLES_BENCHMARK_H_
+#define UGDK_EXAMPLES_BENCHMARK_H_
+
+#include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/input/events.h>
+#include <ugdk/input/joystick.h>
+
+#include <examples/clock.h>
+#include <examples/profiler.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// Command line options shared by every example:
+//   --bench-frames=N    run for N frames and then finish the scene
+//   --bench-dt=SECONDS  pass this fixed dt to the scene tasks (default 1/60)
+//   --bench-csv=PATH    where to write the per-frame timings (default stdout)
+//   --profile-hud       show the profiler's rolling per-phase timings
+//   --profile-trace=PATH  write every profiled scope as a Chrome trace on exit
+// The --profile- options need the UGDK_EXAMPLES_PROFILER CMake option.
+struct BenchmarkOptions {
+    BenchmarkOptions()
+        : frames(0)
+        , dt(1.0 / 60.0)
+        , profile_hud(false)
+    {}
+
+    bool enabled() const { return frames > 0; }
+
+    unsigned frames;
+    double dt;
+    std::string csv_path;
+    bool profile_hud;
+    std::string profile_trace_path;
+};
+
+inline BenchmarkOptions ParseBenchmarkOptions(int argc, char* argv[]) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--bench-frames=", 15) == 0)
+            options.frames = static_cast<unsigned>(std::strtoul(arg + 15, nullptr, 10));
+        else if (std::strncmp(arg, "--bench-dt=", 11) == 0)
+            options.dt = std::strtod(arg + 11, nullptr);
+        else if (std::strncmp(arg, "--bench-csv=", 12) == 0)
+            options.csv_path = arg + 12;
+        else if (std::strcmp(arg, "--profile-hud") == 0)
+            options.profile_hud = true;
+        else if (std::strncmp(arg, "--profile-trace=", 16) == 0)
+            options.profile_trace_path = arg + 16;
+    }
+    return options;
+}
+
+// Returns true if arg is one of the options above, so examples can skip it
+// when reading their own positional arguments.
+inline bool IsBenchmarkOption(const char* arg) {
+    return std::strncmp(arg, "--bench-", 8) == 0 || std::strncmp(arg, "--profile-", 10) == 0;
+}
+
+// Runs a scene for a fixed number of frames with a fixed dt and records how long
+// each frame spent in the scene tasks, in the render function, and everywhere
+// else (event dispatch, buffer swap and engine overhead).
+//
+// Usage, in this order:
+//   examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+//   bench.Configure(config);                      // before system::Initialize
+//   bench.Attach(*scene);                         // before adding any task
+//   scene->AddTask(bench.Task(...));
+//   scene->set_render_function(bench.Render(...));
+//
+// The wrappers also mark the frame's phases for examples::Profiler: each task is
+// a phase named by Task's second argument, and the render function is "render".
+// Attach adds an "events" phase, from the first input event the scene or one of
+// its joysticks gets in a frame to the start of the update, which covers the
+// dispatch of every input event to its listeners.
+// When no benchmark was requested and the profiler isn't compiled in, every call
+// is a pass-through.
+class FrameBenchmark {
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (double)> TaskFunction;
+    typedef std::function<void (ugdk::graphic::Canvas&)> RenderFunction;
+
+    struct FrameTimes {
+        double update_ms, render_ms, other_ms;
+    };
+
+    explicit FrameBenchmark(const BenchmarkOptions& options)
+        : options_(options)
+        , frame_(0)
+        , written_(false)
+    {
+        if (options_.enabled())
+            frames_.reserve(options_.frames);
+        if (Profiler::compiled_in()) {
+            Profiler::instance().set_hud_enabled(options_.profile_hud);
+            Profiler::instance().set_trace_path(options_.profile_trace_path);
+        } else if (options_.profile_hud || !options_.profile_trace_path.empty()) {
+            std::fprintf(stderr, "The profiler isn't compiled in; configure with -DUGDK_EXAMPLES_PROFILER=ON.\n");
+        }
+    }
+
+    ~FrameBenchmark() {
+        WriteCSV();
+    }
+
+    bool enabled() const { return options_.enabled(); }
+    const BenchmarkOptions& options() const { return options_; }
+
+    // Frame pacing would only measure the display, so vsync is turned off.
+    void Configure(ugdk::system::Configuration& config) const {
+        if (!enabled())
+            return;
+        for (auto& window : config.windows_list)
+            window.vsync = false;
+    }
+
+    // Adds the task that marks the start of the update phase.
+    void Attach(ugdk::action::Scene& scene) {
+        if (!wrapping())
+            return;
+        if (Profiler::compiled_in())
+            AttachEventTiming(scene);
+        scene.AddTask([this](double) {
+            if (Profiler::compiled_in()) {
+                if (first_event_ != Clock::time_point()) {
+                    Profiler::instance().Record("events", true, first_event_, Clock::now());
+                    first_event_ = Clock::time_point();
+                }
+                Profiler::instance().BeginFrame();
+            }
+            if (!enabled())
+                return;
+            Clock::time_point now = Clock::now();
+            if (frame_ > 0)
+                current_.other_ms = Milliseconds(render_end_, now);
+            update_begin_ = now;
+        });
+        // Scenes without a render function still get their frames counted.
+        scene.set_render_function(Render(RenderFunction()));
+    }
+
+    TaskFunction Task(const TaskFunction& task, const char* name = "update") const {
+        if (!wrapping())
+            return task;
+        bool fixed_dt = enabled();
+        double dt = options_.dt;
+        return [task, name, fixed_dt, dt](double scene_dt) {
+            EXAMPLES_PROFILE_PHASE(name);
+            task(fixed_dt ? dt : scene_dt);
+        };
+    }
+
+    RenderFunction Render(const RenderFunction& render) {
+        if (!wrapping())
+            return render;
+        return [this, render](ugdk::graphic::Canvas& canvas) {
+            Clock::time_point begin = Clock::now();
+            if (render) {
+                EXAMPLES_PROFILE_PHASE("render");
+                render(canvas);
+            }
+            if (Profiler::compiled_in()) {
+                EXAMPLES_PROFILE_PHASE("profiler hud");
+                Profiler::instance().DrawHUD(canvas);
+            }
+            if (!enabled())
+                return;
+            render_end_ = Clock::now();
+            current_.update_ms = Milliseconds(update_begin_, begin);
+            current_.render_ms = Milliseconds(begin, render_end_);
+            EndFrame();
+        };
+    }
+
+    const std::vector<FrameTimes>& frames() const { return frames_; }
+
+    // Writes "frame,dt,update_ms,render_ms,other_ms". other_ms of a frame is the
+    // time between the end of its render and the start of the next update.
+    void WriteCSV() {
+        if (!enabled() || written_)
+            return;
+        written_ = true;
+        FILE* out = options_.csv_path.empty() ? stdout : std::fopen(options_.csv_path.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "Unable to open '%s' for writing.\n", options_.csv_path.c_str());
+            return;
+        }
+        std::fprintf(out, "frame,dt,update_ms,render_ms,other_ms\n");
+        for (std::size_t i = 0; i < frames_.size(); ++i) {
+            double other_ms = i + 1 < frames_.size() ? frames_[i + 1].other_ms : 0.0;
+            std::fprintf(out, "%u,%f,%f,%f,%f\n", static_cast<unsigned>(i), options_.dt,
+                         frames_[i].update_ms, frames_[i].render_ms, other_ms);
+        }
+        if (out != stdout)
+            std::fclose(out);
+    }
+
+  private:
+    bool wrapping() const { return enabled() || Profiler::compiled_in(); }
+
+    void MarkEvent() {
+        if (first_event_ == Clock::time_point())
+            first_event_ = Clock::now();
+    }
+
+    // Listens before the example does, since Attach comes before its own listeners.
+    void AttachEventTiming(ugdk::action::Scene& scene) {
+        using namespace ugdk::input;
+        scene.event_handler().AddListener<KeyPressedEvent>([this](const KeyPressedEvent&) { MarkEvent(); });
+        scene.event_handler().AddListener<KeyReleasedEvent>([this](const KeyReleasedEvent&) { MarkEvent(); });
+        scene.event_handler().AddListener<MouseMotionEvent>([this](const MouseMotionEvent&) { MarkEvent(); });
+        scene.event_handler().AddListener<MouseButtonPressedEvent>([this](const MouseButtonPressedEvent&) { MarkEvent(); });
+        scene.event_handler().AddListener<MouseButtonReleasedEvent>([this](const MouseButtonReleasedEvent&) { MarkEvent(); });
+        scene.event_handler().AddListener<JoystickConnectedEvent>([this](const JoystickConnectedEvent& ev) {
+            MarkEvent();
+            std::shared_ptr<Joystick> joystick = ev.joystick.lock();
+            if (!joystick)
+                return;
+            joystick->event_handler().AddListener<JoystickAxisEvent>([this](const JoystickAxisEvent&) { MarkEvent(); });
+            joystick->event_handler().AddListener<JoystickButtonPressedEvent>([this](const JoystickButtonPressedEvent&) {
+                MarkEvent();
+            });
+            joystick->event_handler().AddListener<JoystickButtonReleasedEvent>([this](const JoystickButtonReleasedEvent&) {
+                MarkEvent();
+            });
+            joystick->event_handler().AddListener<JoystickHatEvent>([this](const JoystickHatEvent&) { MarkEvent(); });
+        });
+    }
+
+    void EndFrame() {
+        frames_.push_back(current_);
+        current_.other_ms = 0.0;
+        if (++frame_ == options_.frames) {
+            WriteCSV();
+            ugdk::system::CurrentScene().Finish();
+        }
+    }
+
+    BenchmarkOptions options_;
+    unsigned frame_;
+    bool written_;
+    FrameTimes current_ = FrameTimes();
+    Clock::time_point update_begin_, render_end_, first_event_;
+    std::vector<FrameTimes> frames_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_BENCHMARK_H_
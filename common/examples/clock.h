@@ -0,0 +1,15 @@
+#ifndef UGDK_EXAMPLES_CLOCK_H_
+#define UGDK_EXAMPLES_CLOCK_H_
+
+#include <chrono>
+
+namespace examples {
+
+// Time from one steady_clock reading to another, in milliseconds.
+inline double Milliseconds(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_CLOCK_H_
@@ -0,0 +1,69 @@
+#ifndef UGDK_EXAMPLES_EVENTBATCHER_H_
+#define UGDK_EXAMPLES_EVENTBATCHER_H_
+
+#include <ugdk/system/eventhandler.h>
+
+#include <examples/eventbuffer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace examples {
+
+// Opt-in alternative to system::Listener<Event> that gets every event of the
+// frame at once, as a contiguous array.
+template<typename Event>
+class BatchListener {
+  public:
+    virtual ~BatchListener() {}
+    virtual void HandleBatch(const Event* begin, const Event* end) = 0;
+};
+
+// Listens to an EventHandler like any other system::Listener<Event>, but only
+// stores the events. Flush, usually called once per frame from a scene task,
+// hands them to every BatchListener in a single call each.
+//
+// Register it with handler.AddObjectListener(&batcher) and remove it the same way.
+//
+// Buffering costs more than it saves when handling one event is cheap, as in
+// joystick-box; measure with event-dispatch-bench before using it.
+template<typename Event>
+class EventBatcher : public ugdk::system::Listener<Event> {
+  public:
+    typedef typename EventBuffer<Event>::KeyFunction KeyFunction;
+
+    // Keeps only the last event for each key, see EventBuffer.
+    void EnableCoalescing(KeyFunction key_function, std::size_t max_keys) {
+        buffer_.EnableCoalescing(key_function, max_keys);
+    }
+
+    void AddBatchListener(BatchListener<Event>* listener) {
+        listeners_.push_back(listener);
+    }
+
+    void RemoveBatchListener(BatchListener<Event>* listener) {
+        listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), listener), listeners_.end());
+    }
+
+    void Handle(const Event& ev) override {
+        buffer_.Add(ev);
+    }
+
+    void Flush() {
+        if (buffer_.empty())
+            return;
+        for (BatchListener<Event>* listener : listeners_)
+            listener->HandleBatch(buffer_.begin(), buffer_.end());
+        buffer_.Clear();
+    }
+
+    const EventBuffer<Event>& buffer() const { return buffer_; }
+
+  private:
+    EventBuffer<Event> buffer_;
+    std::vector<BatchListener<Event>*> listeners_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_EVENTBATCHER_H_
@@ -0,0 +1,80 @@
+#ifndef UGDK_EXAMPLES_EVENTBUFFER_H_
+#define UGDK_EXAMPLES_EVENTBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace examples {
+
+// Stores the events of one type received during a frame in a contiguous array.
+//
+// With coalescing enabled, each event is mapped to a small integer key (an axis id,
+// a window, ...) by a KeyFunction and only the last event of each key is kept, in
+// the position of the first one. Events whose key isn't smaller than max_keys are
+// all kept, so max_keys must cover every key that should be coalesced.
+template<typename Event>
+class EventBuffer {
+  public:
+    typedef std::size_t (*KeyFunction)(const Event&);
+
+    EventBuffer()
+        : key_function_(nullptr)
+        , generation_(1)
+    {}
+
+    void EnableCoalescing(KeyFunction key_function, std::size_t max_keys) {
+        key_function_ = key_function;
+        slots_.assign(max_keys, Slot());
+    }
+
+    bool coalescing() const { return key_function_ != nullptr; }
+
+    void Add(const Event& ev) {
+        if (key_function_) {
+            std::size_t key = key_function_(ev);
+            if (key < slots_.size()) {
+                Slot& slot = slots_[key];
+                if (slot.generation == generation_) {
+                    events_[slot.index] = ev;
+                    ++coalesced_;
+                    return;
+                }
+                slot.generation = generation_;
+                slot.index = events_.size();
+            }
+        }
+        events_.push_back(ev);
+    }
+
+    // Forgets every event, keeping the memory for the next frame.
+    void Clear() {
+        events_.clear();
+        ++generation_;
+    }
+
+    bool empty() const { return events_.empty(); }
+    std::size_t size() const { return events_.size(); }
+    const Event* begin() const { return events_.data(); }
+    const Event* end() const { return events_.data() + events_.size(); }
+
+    // Number of events replaced by a newer one with the same key, since construction.
+    std::size_t coalesced() const { return coalesced_; }
+
+  private:
+    struct Slot {
+        Slot() : generation(0), index(0) {}
+        uint32_t generation;
+        std::size_t index;
+    };
+
+    KeyFunction key_function_;
+    uint32_t generation_;
+    std::size_t coalesced_ = 0;
+    std::vector<Event> events_;
+    std::vector<Slot> slots_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_EVENTBUFFER_H_
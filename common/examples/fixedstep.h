@@ -0,0 +1,196 @@
+#ifndef UGDK_EXAMPLES_FIXEDSTEP_H_
+#define UGDK_EXAMPLES_FIXEDSTEP_H_
+
+#include <ugdk/graphic/canvas.h>
+
+#include <examples/clock.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace examples {
+
+// Command line options for examples that use a FixedStep:
+//   --fixed-step=HZ        simulate at HZ steps per second instead of once per frame
+//   --max-catch-up=N       most steps simulated in a single frame (default 5)
+//   --fps-limit=FPS        wait so frames take at least 1/FPS seconds
+//   --limiter-spin-ms=MS   the last MS of that wait are spent spinning (default 1)
+struct FixedStepOptions {
+    FixedStepOptions()
+        : step(0.0)
+        , max_steps(5)
+        , fps_limit(0.0)
+        , spin_ms(1.0)
+    {}
+
+    bool enabled() const { return step > 0.0 || fps_limit > 0.0; }
+
+    double step;
+    unsigned max_steps;
+    double fps_limit;
+    double spin_ms;
+};
+
+inline FixedStepOptions ParseFixedStepOptions(int argc, char* argv[]) {
+    FixedStepOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--fixed-step=", 13) == 0) {
+            double hz = std::strtod(arg + 13, nullptr);
+            options.step = hz > 0.0 ? 1.0 / hz : 0.0;
+        } else if (std::strncmp(arg, "--max-catch-up=", 15) == 0) {
+            options.max_steps = std::max(1, std::atoi(arg + 15));
+        } else if (std::strncmp(arg, "--fps-limit=", 12) == 0) {
+            options.fps_limit = std::strtod(arg + 12, nullptr);
+        } else if (std::strncmp(arg, "--limiter-spin-ms=", 18) == 0) {
+            options.spin_ms = std::strtod(arg + 18, nullptr);
+        }
+    }
+    return options;
+}
+
+// Runs the simulation with a fixed step whatever the frame rate: the frame's dt is
+// accumulated and simulated in as many steps as fit, up to max_steps per frame,
+// with the leftover carried to the next frame. Rendering should interpolate
+// between the last two states with alpha().
+//
+// The frame limiter sleeps until shortly before the frame's deadline and spins
+// for the rest, so idle frames cost little CPU but still end on time.
+//
+// Usage:
+//   examples::FixedStep fixed(examples::ParseFixedStepOptions(argc, argv));
+//   scene->AddTask(bench.Task(fixed.Task([](double step) { ... })));
+//   scene->set_render_function(bench.Render(fixed.Render([&fixed](graphic::Canvas&) { ... fixed.alpha() ... })));
+//
+// The frame time histogram and the other stats are printed by the destructor.
+// Without options, tasks get the frame's dt and alpha() is always 1.
+class FixedStep {
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (double)> TaskFunction;
+    typedef std::function<void (ugdk::graphic::Canvas&)> RenderFunction;
+
+    // Frame times are counted in 1 ms buckets, the last one being everything slower.
+    static const std::size_t HISTOGRAM_BUCKETS = 50;
+
+    explicit FixedStep(const FixedStepOptions& options)
+        : options_(options)
+        , accumulator_(0.0)
+        , alpha_(1.0)
+        , frames_(0)
+        , missed_deadlines_(0)
+        , dropped_time_(0.0)
+        , frame_histogram_(HISTOGRAM_BUCKETS, 0)
+        , steps_histogram_(options.max_steps + 1, 0)
+        , started_(false)
+    {}
+
+    ~FixedStep() {
+        if (options_.enabled() && frames_ > 0)
+            PrintStats();
+    }
+
+    const FixedStepOptions& options() const { return options_; }
+
+    // Interpolation factor between the previous and the current simulation state.
+    double alpha() const { return alpha_; }
+
+    TaskFunction Task(const TaskFunction& simulate) {
+        if (options_.step <= 0.0)
+            return simulate;
+        return [this, simulate](double dt) {
+            accumulator_ += dt;
+            unsigned steps = 0;
+            while (accumulator_ >= options_.step && steps < options_.max_steps) {
+                simulate(options_.step);
+                accumulator_ -= options_.step;
+                ++steps;
+            }
+            // Too far behind: give up on the time that couldn't be simulated.
+            if (accumulator_ >= options_.step) {
+                double leftover = std::fmod(accumulator_, options_.step);
+                dropped_time_ += accumulator_ - leftover;
+                accumulator_ = leftover;
+            }
+            alpha_ = accumulator_ / options_.step;
+            ++steps_histogram_[steps];
+        };
+    }
+
+    RenderFunction Render(const RenderFunction& render) {
+        if (!options_.enabled())
+            return render;
+        return [this, render](ugdk::graphic::Canvas& canvas) {
+            if (render)
+                render(canvas);
+            EndFrame();
+        };
+    }
+
+    void PrintStats() const {
+        double deadline_ms = DeadlineMilliseconds();
+        std::printf("%u frames, %u missed the %.2f ms deadline, %.1f ms of simulation dropped\n",
+                    frames_, missed_deadlines_, deadline_ms, dropped_time_ * 1000.0);
+        std::printf("frame time histogram:\n");
+        for (std::size_t i = 0; i < frame_histogram_.size(); ++i)
+            if (frame_histogram_[i] > 0)
+                std::printf("  %2u%s ms: %u\n", static_cast<unsigned>(i),
+                            i + 1 == frame_histogram_.size() ? "+" : " ", frame_histogram_[i]);
+        if (options_.step > 0.0) {
+            std::printf("simulation steps per frame:\n");
+            for (std::size_t i = 0; i < steps_histogram_.size(); ++i)
+                std::printf("  %u: %u\n", static_cast<unsigned>(i), steps_histogram_[i]);
+        }
+    }
+
+  private:
+    // A frame misses its deadline when it takes longer than the limiter's period or,
+    // without a limiter, longer than a simulation step.
+    double DeadlineMilliseconds() const {
+        if (options_.fps_limit > 0.0)
+            return 1000.0 / options_.fps_limit;
+        return options_.step * 1000.0;
+    }
+
+    void EndFrame() {
+        Clock::time_point now = Clock::now();
+        if (options_.fps_limit > 0.0 && started_) {
+            Clock::time_point deadline = frame_start_ + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(1.0 / options_.fps_limit));
+            Clock::time_point wake = deadline - std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double, std::milli>(options_.spin_ms));
+            if (now < wake)
+                std::this_thread::sleep_until(wake);
+            while ((now = Clock::now()) < deadline) {}
+        }
+        if (started_) {
+            double frame_ms = Milliseconds(frame_start_, now);
+            std::size_t bucket = std::min(static_cast<std::size_t>(frame_ms), frame_histogram_.size() - 1);
+            ++frame_histogram_[bucket];
+            if (frame_ms > DeadlineMilliseconds() * 1.05)
+                ++missed_deadlines_;
+            ++frames_;
+        }
+        started_ = true;
+        frame_start_ = now;
+    }
+
+    FixedStepOptions options_;
+    double accumulator_, alpha_;
+    unsigned frames_, missed_deadlines_;
+    double dropped_time_;
+    std::vector<unsigned> frame_histogram_, steps_histogram_;
+    bool started_;
+    Clock::time_point frame_start_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_FIXEDSTEP_H_
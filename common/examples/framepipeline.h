@@ -0,0 +1,88 @@
+#ifndef UGDK_EXAMPLES_FRAMEPIPELINE_H_
+#define UGDK_EXAMPLES_FRAMEPIPELINE_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace examples {
+
+// Runs one job at a time on its own thread, so the simulation of the next frame
+// can run while the main thread draws the current one.
+//
+// Ownership: between Start and the Wait that follows it, whatever the job writes
+// belongs to the job's thread, and the main thread must neither read nor write it.
+// Whatever the job only reads may still be read, but not written, by the main
+// thread. Wait hands everything back to the main thread. Drawing stays on the main
+// thread, since that is where the GL context is current.
+class FramePipeline {
+  public:
+    typedef std::function<void ()> Job;
+
+    FramePipeline()
+        : busy_(false)
+        , stopping_(false)
+        , thread_([this] { Loop(); })
+    {}
+
+    ~FramePipeline() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return !busy_; });
+            stopping_ = true;
+        }
+        start_.notify_one();
+        thread_.join();
+    }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Waits for the previous job, then starts job on the pipeline's thread.
+    void Start(Job job) {
+        Wait();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = std::move(job);
+            busy_ = true;
+        }
+        start_.notify_one();
+    }
+
+    // Blocks until the current job, if any, is done. Returns how long it blocked, in
+    // milliseconds: near zero when the job is no slower than the main thread.
+    double Wait() {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return !busy_; });
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    }
+
+  private:
+    void Loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            start_.wait(lock, [this] { return busy_ || stopping_; });
+            if (!busy_)
+                return;
+            Job job = std::move(job_);
+            lock.unlock();
+            job();
+            lock.lock();
+            busy_ = false;
+            done_.notify_all();
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    Job job_;
+    bool busy_, stopping_;
+    std::thread thread_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_FRAMEPIPELINE_H_
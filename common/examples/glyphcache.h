@@ -0,0 +1,289 @@
+#ifndef UGDK_EXAMPLES_GLYPHCACHE_H_
+#define UGDK_EXAMPLES_GLYPHCACHE_H_
+
+#include <examples/mappedfile.h>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// Where a glyph is in its atlas, and how to place it relative to the pen.
+struct GlyphMetrics {
+    uint32_t codepoint;
+    uint16_t x, y, width, height;
+    int16_t bearing_x, bearing_y;
+    int16_t advance;
+    uint16_t padding;
+};
+static_assert(sizeof(GlyphMetrics) == 20, "GlyphMetrics is stored as is in cache files.");
+
+const char GLYPH_CACHE_MAGIC[8] = { 'U', 'G', 'D', 'K', 'G', 'L', 'Y', 'F' };
+
+// The glyphs of one font at one pixel size, rasterized into a single 8-bit
+// coverage atlas. Either owns its memory or points into a mapped cache file.
+class GlyphAtlas {
+  public:
+    GlyphAtlas() : glyphs_(nullptr), num_glyphs_(0), pixels_(nullptr), width_(0), height_(0), line_height_(0) {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int line_height() const { return line_height_; }
+    const uint8_t* pixels() const { return pixels_; }
+    std::size_t num_glyphs() const { return num_glyphs_; }
+    const GlyphMetrics* glyphs() const { return glyphs_; }
+
+    // Glyphs are sorted by codepoint. Returns null for codepoints the atlas lacks.
+    const GlyphMetrics* Find(uint32_t codepoint) const {
+        const GlyphMetrics* end = glyphs_ + num_glyphs_;
+        const GlyphMetrics* it = std::lower_bound(glyphs_, end, codepoint,
+            [](const GlyphMetrics& glyph, uint32_t c) { return glyph.codepoint < c; });
+        return it != end && it->codepoint == codepoint ? it : nullptr;
+    }
+
+  private:
+    friend class GlyphCache;
+
+    std::vector<GlyphMetrics> owned_glyphs_;
+    std::vector<uint8_t> owned_pixels_;
+    std::unique_ptr<MappedFile> mapping_;
+    const GlyphMetrics* glyphs_;
+    std::size_t num_glyphs_;
+    const uint8_t* pixels_;
+    int width_, height_, line_height_;
+};
+
+// Decodes UTF-8 into sorted, unique codepoints, for the charset of a cache.
+// Malformed bytes are skipped.
+inline std::vector<uint32_t> CodepointsOf(const char* text, std::size_t size) {
+    std::vector<uint32_t> result;
+    for (std::size_t i = 0; i < size;) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        int length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+        if (length == 0 || i + length > size) {
+            ++i;
+            continue;
+        }
+        uint32_t codepoint = length == 1 ? lead : lead & (0x7F >> length);
+        for (int k = 1; k < length; ++k)
+            codepoint = codepoint << 6 | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+        result.push_back(codepoint);
+        i += length;
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+// Rasterizes the glyphs of a font with FreeType and keeps the result in a
+// versioned binary file, so later runs map the atlas instead of parsing the font
+// and rasterizing every glyph again.
+//
+// Cache files are named after the hashes of the font and the charset and the pixel
+// size, and are only used when their header matches the font contents, size and
+// charset. They're
+// written to a temporary name and renamed, so a crash never leaves a torn cache.
+class GlyphCache {
+  public:
+    // Bumped whenever the file layout or the rasterization changes.
+    static const uint32_t VERSION = 1;
+
+    explicit GlyphCache(const std::string& directory)
+        : directory_(directory)
+        , hits_(0)
+        , misses_(0)
+    {}
+
+    unsigned hits() const { return hits_; }
+    unsigned misses() const { return misses_; }
+
+    // Returns the atlas of the given codepoints, from the cache when possible.
+    // Returns null if the font can't be read.
+    std::unique_ptr<GlyphAtlas> Load(const std::string& font_path, int pixel_size, const std::vector<uint32_t>& codepoints) {
+        MappedFile font(font_path);
+        if (!font.is_open()) {
+            std::fprintf(stderr, "Unable to open font '%s'.\n", font_path.c_str());
+            return nullptr;
+        }
+        return Load(font.data(), font.size(), pixel_size, codepoints);
+    }
+
+    // Same, from a font already in memory, such as one read from an AssetPack.
+    std::unique_ptr<GlyphAtlas> Load(const char* font_data, std::size_t font_size, int pixel_size,
+                                     const std::vector<uint32_t>& codepoints) {
+        Header expected = Header();
+        std::memcpy(expected.magic, GLYPH_CACHE_MAGIC, sizeof(expected.magic));
+        expected.version = VERSION;
+        expected.pixel_size = static_cast<uint32_t>(pixel_size);
+        expected.font_hash = Hash(font_data, font_size);
+        expected.charset_hash = Hash(reinterpret_cast<const char*>(codepoints.data()), codepoints.size() * sizeof(uint32_t));
+
+        std::string path = CachePath(expected);
+        if (std::unique_ptr<GlyphAtlas> atlas = Map(path, expected)) {
+            ++hits_;
+            return atlas;
+        }
+        ++misses_;
+        std::unique_ptr<GlyphAtlas> atlas = Rasterize(font_data, font_size, pixel_size, codepoints);
+        if (atlas)
+            Write(path, expected, *atlas);
+        return atlas;
+    }
+
+    // Rasterizes without the cache, from a font already in memory.
+    static std::unique_ptr<GlyphAtlas> Rasterize(const MappedFile& font, int pixel_size, const std::vector<uint32_t>& codepoints) {
+        return Rasterize(font.data(), font.size(), pixel_size, codepoints);
+    }
+
+    static std::unique_ptr<GlyphAtlas> Rasterize(const char* font_data, std::size_t font_size, int pixel_size,
+                                                 const std::vector<uint32_t>& codepoints) {
+        FT_Library library;
+        if (FT_Init_FreeType(&library))
+            return nullptr;
+        FT_Face face;
+        if (FT_New_Memory_Face(library, reinterpret_cast<const FT_Byte*>(font_data), static_cast<FT_Long>(font_size), 0, &face)) {
+            FT_Done_FreeType(library);
+            return nullptr;
+        }
+        FT_Set_Pixel_Sizes(face, 0, pixel_size);
+
+        std::unique_ptr<GlyphAtlas> atlas(new GlyphAtlas);
+        atlas->line_height_ = static_cast<int>(face->size->metrics.height >> 6);
+        // Glyphs go in rows, left to right, on an atlas of about square area.
+        atlas->width_ = std::max(256, static_cast<int>(std::sqrt(static_cast<double>(codepoints.size())) * pixel_size * 1.1));
+        std::vector<uint8_t>& pixels = atlas->owned_pixels_;
+        int pen_x = 1, pen_y = 1, row_height = 0;
+        for (uint32_t codepoint : codepoints) {
+            FT_UInt index = FT_Get_Char_Index(face, codepoint);
+            if (index == 0 || FT_Load_Glyph(face, index, FT_LOAD_RENDER))
+                continue;
+            const FT_Bitmap& bitmap = face->glyph->bitmap;
+            int w = static_cast<int>(bitmap.width), h = static_cast<int>(bitmap.rows);
+            if (pen_x + w + 1 > atlas->width_) {
+                pen_x = 1;
+                pen_y += row_height + 1;
+                row_height = 0;
+            }
+            if (static_cast<std::size_t>(pen_y + h + 1) * atlas->width_ > pixels.size())
+                pixels.resize(static_cast<std::size_t>(pen_y + h + 1) * atlas->width_, 0);
+            for (int row = 0; row < h; ++row)
+                std::memcpy(&pixels[static_cast<std::size_t>(pen_y + row) * atlas->width_ + pen_x],
+                            bitmap.buffer + row * bitmap.pitch, w);
+            GlyphMetrics glyph = {
+                codepoint, static_cast<uint16_t>(pen_x), static_cast<uint16_t>(pen_y),
+                static_cast<uint16_t>(w), static_cast<uint16_t>(h),
+                static_cast<int16_t>(face->glyph->bitmap_left), static_cast<int16_t>(face->glyph->bitmap_top),
+                static_cast<int16_t>(face->glyph->advance.x >> 6), 0
+            };
+            atlas->owned_glyphs_.push_back(glyph);
+            pen_x += w + 1;
+            row_height = std::max(row_height, h);
+        }
+        FT_Done_Face(face);
+        FT_Done_FreeType(library);
+
+        atlas->height_ = static_cast<int>(pixels.size() / atlas->width_);
+        atlas->glyphs_ = atlas->owned_glyphs_.data();
+        atlas->num_glyphs_ = atlas->owned_glyphs_.size();
+        atlas->pixels_ = pixels.data();
+        return atlas;
+    }
+
+    // 64-bit FNV-1a over 8-byte words, then the remaining bytes.
+    static uint64_t Hash(const char* data, std::size_t size) {
+        const uint64_t prime = 0x100000001b3ULL;
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            uint64_t word;
+            std::memcpy(&word, data + i, 8);
+            hash = (hash ^ word) * prime;
+        }
+        for (; i < size; ++i)
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+        return hash;
+    }
+
+  private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t pixel_size;
+        uint64_t font_hash;
+        uint64_t charset_hash;
+        uint32_t num_glyphs;
+        uint32_t width, height;
+        int32_t line_height;
+    };
+    static_assert(sizeof(Header) == 48, "Header is stored as is in cache files.");
+
+    std::string CachePath(const Header& header) const {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%016llx-%016llx-%u.glyphs", static_cast<unsigned long long>(header.font_hash),
+                      static_cast<unsigned long long>(header.charset_hash), header.pixel_size);
+        return directory_ + "/" + name;
+    }
+
+    static std::unique_ptr<GlyphAtlas> Map(const std::string& path, const Header& expected) {
+        std::unique_ptr<MappedFile> file(new MappedFile);
+        if (!file->Open(path) || file->size() < sizeof(Header))
+            return nullptr;
+        Header header;
+        std::memcpy(&header, file->data(), sizeof(Header));
+        if (std::memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 || header.version != expected.version
+                || header.pixel_size != expected.pixel_size || header.font_hash != expected.font_hash
+                || header.charset_hash != expected.charset_hash)
+            return nullptr;
+        std::size_t glyphs_size = header.num_glyphs * sizeof(GlyphMetrics);
+        if (file->size() != sizeof(Header) + glyphs_size + static_cast<std::size_t>(header.width) * header.height)
+            return nullptr;
+
+        std::unique_ptr<GlyphAtlas> atlas(new GlyphAtlas);
+        atlas->glyphs_ = reinterpret_cast<const GlyphMetrics*>(file->data() + sizeof(Header));
+        atlas->num_glyphs_ = header.num_glyphs;
+        atlas->pixels_ = reinterpret_cast<const uint8_t*>(file->data() + sizeof(Header) + glyphs_size);
+        atlas->width_ = static_cast<int>(header.width);
+        atlas->height_ = static_cast<int>(header.height);
+        atlas->line_height_ = header.line_height;
+        atlas->mapping_ = std::move(file);
+        return atlas;
+    }
+
+    static void Write(const std::string& path, Header header, const GlyphAtlas& atlas) {
+        header.num_glyphs = static_cast<uint32_t>(atlas.num_glyphs());
+        header.width = static_cast<uint32_t>(atlas.width());
+        header.height = static_cast<uint32_t>(atlas.height());
+        header.line_height = atlas.line_height();
+        std::string temporary = path + ".tmp";
+        FILE* out = std::fopen(temporary.c_str(), "wb");
+        if (!out) {
+            std::fprintf(stderr, "Unable to open '%s' for writing.\n", temporary.c_str());
+            return;
+        }
+        bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1
+            && std::fwrite(atlas.glyphs(), sizeof(GlyphMetrics), atlas.num_glyphs(), out) == atlas.num_glyphs()
+            && std::fwrite(atlas.pixels(), 1, static_cast<std::size_t>(atlas.width()) * atlas.height(), out)
+                == static_cast<std::size_t>(atlas.width()) * atlas.height();
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::fprintf(stderr, "Unable to write the glyph cache '%s'.\n", path.c_str());
+            std::remove(temporary.c_str());
+        }
+    }
+
+    std::string directory_;
+    unsigned hits_, misses_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_GLYPHCACHE_H_
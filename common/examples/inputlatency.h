@@ -0,0 +1,187 @@
+#ifndef UGDK_EXAMPLES_INPUTLATENCY_H_
+#define UGDK_EXAMPLES_INPUTLATENCY_H_
+
+#include <ugdk/action/scene.h>
+#include <ugdk/desktop/window.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/input/events.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace examples {
+
+// Reads:
+//   --coalesce-motion   deliver only the newest mouse motion of each window per frame
+//   --latency-csv=PATH  write the input latencies of every frame to PATH
+struct LatencyOptions {
+    LatencyOptions() : coalesce_motion(false) {}
+
+    bool coalesce_motion;
+    std::string csv_path;
+};
+
+inline LatencyOptions ParseLatencyOptions(int argc, char* argv[]) {
+    LatencyOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--coalesce-motion") == 0)
+            options.coalesce_motion = true;
+        else if (std::strncmp(argv[i], "--latency-csv=", 14) == 0)
+            options.csv_path = argv[i] + 14;
+    }
+    return options;
+}
+
+// Measures how old input is when the frame that shows it is presented.
+//
+// ugdk events carry no capture time, so events are stamped when their listener
+// receives them, which is right after the engine polls them at the start of the
+// frame. The render function wrapped by Render marks the inputs applied so far as
+// shown by the frame it draws, and that frame counts as presented when the next
+// one starts, since the buffer swap happens in between. The latency of each input
+// is the time from its stamp to that point.
+//
+// Percentiles of the last second are printed once per second, and the min and max
+// of every frame can be written to a CSV file.
+class InputLatency {
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (ugdk::graphic::Canvas&)> RenderFunction;
+
+    explicit InputLatency(const LatencyOptions& options)
+        : out_(options.csv_path.empty() ? nullptr : std::fopen(options.csv_path.c_str(), "w"))
+        , frame_(0)
+        , last_report_(Clock::now())
+    {
+        if (!options.csv_path.empty() && !out_)
+            std::fprintf(stderr, "Unable to open '%s' for writing.\n", options.csv_path.c_str());
+        if (out_)
+            std::fprintf(out_, "frame,inputs,min_ms,max_ms\n");
+    }
+
+    ~InputLatency() {
+        if (out_)
+            std::fclose(out_);
+    }
+
+    InputLatency(const InputLatency&) = delete;
+    InputLatency& operator=(const InputLatency&) = delete;
+
+    // Adds the task that marks the previous frame as presented. Must be called
+    // before any other task is added.
+    void Attach(ugdk::action::Scene& scene) {
+        scene.AddTask([this](double) { Presented(Clock::now()); });
+    }
+
+    // Wraps the scene's render function. The inputs applied before it runs are
+    // shown by the frame it draws.
+    RenderFunction Render(const RenderFunction& render) {
+        return [this, render](ugdk::graphic::Canvas& canvas) {
+            if (render)
+                render(canvas);
+            drawn_.insert(drawn_.end(), applied_.begin(), applied_.end());
+            applied_.clear();
+        };
+    }
+
+    // Records that input received at stamp changed the state the next render shows.
+    void Applied(Clock::time_point stamp) {
+        applied_.push_back(stamp);
+    }
+
+  private:
+    void Presented(Clock::time_point now) {
+        double min_ms = 0.0, max_ms = 0.0;
+        for (std::size_t i = 0; i < drawn_.size(); ++i) {
+            double ms = std::chrono::duration<double, std::milli>(now - drawn_[i]).count();
+            min_ms = i == 0 ? ms : std::min(min_ms, ms);
+            max_ms = std::max(max_ms, ms);
+            samples_.push_back(ms);
+        }
+        if (out_)
+            std::fprintf(out_, "%u,%u,%f,%f\n", frame_, static_cast<unsigned>(drawn_.size()), min_ms, max_ms);
+        drawn_.clear();
+        ++frame_;
+
+        if (now - last_report_ < std::chrono::seconds(1))
+            return;
+        last_report_ = now;
+        if (samples_.empty())
+            return;
+        std::sort(samples_.begin(), samples_.end());
+        auto percentile = [this](double p) {
+            return samples_[std::min(samples_.size() - 1, static_cast<std::size_t>(p * samples_.size()))];
+        };
+        std::printf("input latency: %u inputs, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+                    static_cast<unsigned>(samples_.size()), percentile(0.5), percentile(0.9), percentile(0.99),
+                    samples_.back());
+        samples_.clear();
+    }
+
+    FILE* out_;
+    unsigned frame_;
+    // Stamps of the inputs applied since the last render, and of those the last
+    // render showed.
+    std::vector<Clock::time_point> applied_, drawn_;
+    std::vector<double> samples_;
+    Clock::time_point last_report_;
+};
+
+// Holds the newest mouse motion of each window until Deliver hands them to the
+// handler, so handlers run at most once per window per frame however many motion
+// events arrived. Events keep the time they were received.
+class MotionCoalescer {
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (const ugdk::input::MouseMotionEvent&, Clock::time_point)> Handler;
+
+    explicit MotionCoalescer(const Handler& handler)
+        : handler_(handler)
+        , received_(0)
+        , delivered_(0)
+    {}
+
+    void Push(const ugdk::input::MouseMotionEvent& ev, Clock::time_point stamp) {
+        ++received_;
+        const ugdk::desktop::Window* window = ev.window.lock().get();
+        for (Pending& pending : pending_)
+            if (pending.window == window) {
+                pending.event = ev;
+                pending.stamp = stamp;
+                return;
+            }
+        Pending pending = { window, ev, stamp };
+        pending_.push_back(pending);
+    }
+
+    void Deliver() {
+        for (const Pending& pending : pending_)
+            handler_(pending.event, pending.stamp);
+        delivered_ += pending_.size();
+        pending_.clear();
+    }
+
+    unsigned long long received() const { return received_; }
+    unsigned long long delivered() const { return delivered_; }
+
+  private:
+    struct Pending {
+        const ugdk::desktop::Window* window;
+        ugdk::input::MouseMotionEvent event;
+        Clock::time_point stamp;
+    };
+
+    Handler handler_;
+    std::vector<Pending> pending_;
+    unsigned long long received_, delivered_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_INPUTLATENCY_H_
@@ -0,0 +1,309 @@
+#ifndef UGDK_EXAMPLES_INPUTRECORD_H_
+#define UGDK_EXAMPLES_INPUTRECORD_H_
+
+#include <ugdk/system/engine.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/desktop/module.h>
+#include <ugdk/input/events.h>
+#include <ugdk/input/joystick.h>
+#include <ugdk/input/module.h>
+#include <ugdk/input/scancode.h>
+
+#include <examples/mappedfile.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// One input event as stored in a recording. Files are a 16 byte header followed by
+// tightly packed records, in the byte order of the machine that recorded them.
+struct InputRecord {
+    enum Type {
+        KEY_PRESSED = 1,          // a = scancode, b = keycode, c = modifiers | (repeat << 16)
+        KEY_RELEASED,             // a = scancode, b = keycode, c = modifiers
+        MOUSE_MOTION,             // a = x, b = y, c = 0
+        JOYSTICK_CONNECTED,       // a = axes, b = buttons, c = hats
+        JOYSTICK_DISCONNECTED,    // -
+        JOYSTICK_AXIS,            // a = axis, b = value in [-32767, 32767]
+        JOYSTICK_BUTTON_PRESSED,  // a = button
+        JOYSTICK_BUTTON_RELEASED, // a = button
+        JOYSTICK_HAT,             // a = hat, b = dx, c = dy, each in [-1, 1]
+        END_OF_RECORDING = 0xFFFF // frame = last frame of the recording
+    };
+
+    uint32_t frame;
+    uint32_t time_us;
+    uint16_t type;
+    uint16_t device;  // Joystick slot, in connection order.
+    int32_t a, b, c;
+};
+static_assert(sizeof(InputRecord) == 24, "InputRecord must be tightly packed.");
+
+struct InputRecordHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+};
+
+const char INPUT_RECORD_MAGIC[8] = { 'U', 'G', 'D', 'K', 'I', 'N', 'P', 'T' };
+const uint32_t INPUT_RECORD_VERSION = 1;
+
+// Reads --record-input=PATH and --replay-input=PATH.
+struct InputRecordingOptions {
+    std::string record_path, replay_path;
+};
+
+inline InputRecordingOptions ParseInputRecordingOptions(int argc, char* argv[]) {
+    InputRecordingOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--record-input=", 15) == 0)
+            options.record_path = argv[i] + 15;
+        else if (std::strncmp(argv[i], "--replay-input=", 15) == 0)
+            options.replay_path = argv[i] + 15;
+    }
+    return options;
+}
+
+// Whether arg is one of the options above, for examples that take positional arguments.
+inline bool IsInputRecordingOption(const char* arg) {
+    return std::strncmp(arg, "--record-input=", 15) == 0 || std::strncmp(arg, "--replay-input=", 15) == 0;
+}
+
+// Writes every keyboard, mouse motion and joystick event seen by a scene, tagged
+// with the frame it arrived in. Records are buffered and written in blocks.
+class InputRecorder {
+  public:
+    explicit InputRecorder(const std::string& path)
+        : file_(path.empty() ? nullptr : std::fopen(path.c_str(), "wb"))
+        , frame_(0)
+        , next_device_(0)
+        , start_(std::chrono::steady_clock::now())
+    {
+        if (!path.empty() && !file_)
+            std::fprintf(stderr, "Unable to open '%s' for recording.\n", path.c_str());
+        if (!file_)
+            return;
+        InputRecordHeader header;
+        std::memcpy(header.magic, INPUT_RECORD_MAGIC, sizeof(header.magic));
+        header.version = INPUT_RECORD_VERSION;
+        header.record_size = sizeof(InputRecord);
+        std::fwrite(&header, sizeof(header), 1, file_);
+        buffer_.reserve(BUFFER_SIZE);
+    }
+
+    ~InputRecorder() {
+        if (!file_)
+            return;
+        Write(InputRecord::END_OF_RECORDING, 0, 0, 0, 0);
+        Flush();
+        std::fclose(file_);
+    }
+
+    bool is_recording() const { return file_ != nullptr; }
+
+    // Must be called before any other task is added, so events are tagged with
+    // the frame in which the scene saw them.
+    void Attach(ugdk::action::Scene& scene) {
+        if (!file_)
+            return;
+        using namespace ugdk::input;
+        scene.AddTask([this](double) { ++frame_; });
+        scene.event_handler().AddListener<KeyPressedEvent>([this](const KeyPressedEvent& ev) {
+            Write(InputRecord::KEY_PRESSED, 0, static_cast<int32_t>(ev.scancode), static_cast<int32_t>(ev.keycode),
+                  static_cast<int32_t>(ev.modifiers) | (ev.repeat ? 1 << 16 : 0));
+        });
+        scene.event_handler().AddListener<KeyReleasedEvent>([this](const KeyReleasedEvent& ev) {
+            Write(InputRecord::KEY_RELEASED, 0, static_cast<int32_t>(ev.scancode), static_cast<int32_t>(ev.keycode),
+                  static_cast<int32_t>(ev.modifiers));
+        });
+        scene.event_handler().AddListener<MouseMotionEvent>([this](const MouseMotionEvent& ev) {
+            Write(InputRecord::MOUSE_MOTION, 0, ev.position.x, ev.position.y, 0);
+        });
+        scene.event_handler().AddListener<JoystickConnectedEvent>([this](const JoystickConnectedEvent& ev) {
+            AttachJoystick(ev.joystick.lock());
+        });
+    }
+
+  private:
+    static const std::size_t BUFFER_SIZE = 4096;
+
+    void AttachJoystick(const std::shared_ptr<ugdk::input::Joystick>& joystick) {
+        using namespace ugdk::input;
+        uint16_t device = next_device_++;
+        Write(InputRecord::JOYSTICK_CONNECTED, device, joystick->NumAxes(), joystick->NumButtons(), joystick->NumHats());
+        joystick->event_handler().AddListener<JoystickAxisEvent>([this, device](const JoystickAxisEvent& ev) {
+            Write(InputRecord::JOYSTICK_AXIS, device, ev.axis_id,
+                  static_cast<int32_t>(ev.axis_status.Percentage() * 32767), 0);
+        });
+        joystick->event_handler().AddListener<JoystickButtonPressedEvent>([this, device](const JoystickButtonPressedEvent& ev) {
+            Write(InputRecord::JOYSTICK_BUTTON_PRESSED, device, ev.button, 0, 0);
+        });
+        joystick->event_handler().AddListener<JoystickButtonReleasedEvent>([this, device](const JoystickButtonReleasedEvent& ev) {
+            Write(InputRecord::JOYSTICK_BUTTON_RELEASED, device, ev.button, 0, 0);
+        });
+        joystick->event_handler().AddListener<JoystickHatEvent>([this, device](const JoystickHatEvent& ev) {
+            Write(InputRecord::JOYSTICK_HAT, device, ev.hat_id,
+                  (ev.hat_status.HasRight() ? 1 : 0) - (ev.hat_status.HasLeft() ? 1 : 0),
+                  (ev.hat_status.HasDown() ? 1 : 0) - (ev.hat_status.HasUp() ? 1 : 0));
+        });
+        joystick->event_handler().AddListener<JoystickDisconnectedEvent>([this, device](const JoystickDisconnectedEvent&) {
+            Write(InputRecord::JOYSTICK_DISCONNECTED, device, 0, 0, 0);
+        });
+    }
+
+    void Write(InputRecord::Type type, uint16_t device, int32_t a, int32_t b, int32_t c) {
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        InputRecord record;
+        record.frame = frame_;
+        record.time_us = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        record.type = static_cast<uint16_t>(type);
+        record.device = device;
+        record.a = a;
+        record.b = b;
+        record.c = c;
+        buffer_.push_back(record);
+        if (buffer_.size() == BUFFER_SIZE)
+            Flush();
+    }
+
+    void Flush() {
+        if (!buffer_.empty())
+            std::fwrite(buffer_.data(), sizeof(InputRecord), buffer_.size(), file_);
+        buffer_.clear();
+    }
+
+    FILE* file_;
+    uint32_t frame_;
+    uint16_t next_device_;
+    std::chrono::steady_clock::time_point start_;
+    std::vector<InputRecord> buffer_;
+};
+
+// Plays back a recording frame by frame. The file is memory mapped and records are
+// read in place, so replaying allocates nothing per event.
+//
+// Keyboard and mouse records are raised again on the scene's event handler, and
+// the pressed keys are tracked so polling code can call IsDown instead of the
+// keyboard. Joysticks can't be created outside the engine, so joystick records are
+// handed to the joystick function given to Attach. By default the scene finishes
+// on the frame the recording ended.
+class InputReplay {
+  public:
+    typedef std::function<void (const InputRecord&)> JoystickFunction;
+
+    explicit InputReplay(const std::string& path)
+        : begin_(nullptr), end_(nullptr), cursor_(nullptr)
+        , frame_(0)
+        , finish_at_end_(true)
+    {
+        std::memset(keys_down_, 0, sizeof(keys_down_));
+        if (!path.empty() && !Map(path))
+            std::fprintf(stderr, "Unable to replay '%s'.\n", path.c_str());
+    }
+
+    bool is_replaying() const { return begin_ != nullptr; }
+    bool finished() const { return cursor_ == end_; }
+    std::size_t num_records() const { return static_cast<std::size_t>(end_ - begin_); }
+
+    // Finishes the current scene once the last recorded frame has been replayed.
+    void set_finish_at_end(bool finish) { finish_at_end_ = finish; }
+
+    // Must be called before any other task is added, like InputRecorder::Attach.
+    void Attach(ugdk::action::Scene& scene, const JoystickFunction& joystick_function = JoystickFunction()) {
+        if (!is_replaying())
+            return;
+        joystick_function_ = joystick_function;
+        ugdk::system::EventHandler* handler = &scene.event_handler();
+        scene.AddTask([this, handler](double) {
+            Replay(*handler);
+        });
+    }
+
+    bool IsDown(ugdk::input::Scancode scancode) const {
+        std::size_t index = static_cast<std::size_t>(scancode);
+        return index < MAX_SCANCODES && keys_down_[index];
+    }
+
+  private:
+    static const std::size_t MAX_SCANCODES = 512;
+
+    void Replay(ugdk::system::EventHandler& handler) {
+        using namespace ugdk::input;
+        for (; cursor_ != end_ && cursor_->frame <= frame_; ++cursor_) {
+            const InputRecord& record = *cursor_;
+            switch (record.type) {
+            case InputRecord::KEY_PRESSED:
+                SetKey(record.a, true);
+                handler.RaiseEvent(KeyPressedEvent(static_cast<Keycode>(record.b), static_cast<Scancode>(record.a),
+                                                   static_cast<Keymod>(record.c & 0xFFFF), (record.c >> 16) != 0));
+                break;
+            case InputRecord::KEY_RELEASED:
+                SetKey(record.a, false);
+                handler.RaiseEvent(KeyReleasedEvent(static_cast<Keycode>(record.b), static_cast<Scancode>(record.a),
+                                                    static_cast<Keymod>(record.c)));
+                break;
+            case InputRecord::MOUSE_MOTION: {
+                ugdk::math::Integer2D position = { record.a, record.b };
+                ugdk::math::Integer2D motion = { record.a - last_mouse_.x, record.b - last_mouse_.y };
+                last_mouse_ = position;
+                handler.RaiseEvent(MouseMotionEvent(ugdk::desktop::manager()->primary_window(), position, motion));
+                break;
+            }
+            case InputRecord::END_OF_RECORDING:
+                break;
+            default:
+                if (joystick_function_)
+                    joystick_function_(record);
+            }
+        }
+        ++frame_;
+        if (finish_at_end_ && cursor_ == end_)
+            ugdk::system::CurrentScene().Finish();
+    }
+
+    void SetKey(int32_t scancode, bool down) {
+        if (scancode >= 0 && static_cast<std::size_t>(scancode) < MAX_SCANCODES)
+            keys_down_[scancode] = down;
+    }
+
+    bool Map(const std::string& path) {
+        if (!file_.Open(path) || file_.size() < sizeof(InputRecordHeader))
+            return false;
+        const InputRecordHeader* header = reinterpret_cast<const InputRecordHeader*>(file_.data());
+        if (std::memcmp(header->magic, INPUT_RECORD_MAGIC, sizeof(header->magic)) != 0
+                || header->version != INPUT_RECORD_VERSION
+                || header->record_size != sizeof(InputRecord))
+            return false;
+        begin_ = reinterpret_cast<const InputRecord*>(header + 1);
+        end_ = begin_ + (file_.size() - sizeof(InputRecordHeader)) / sizeof(InputRecord);
+        cursor_ = begin_;
+        return true;
+    }
+
+    MappedFile file_;
+    const InputRecord *begin_, *end_, *cursor_;
+    uint32_t frame_;
+    bool finish_at_end_;
+    bool keys_down_[MAX_SCANCODES];
+    ugdk::math::Integer2D last_mouse_ = ugdk::math::Integer2D();
+    JoystickFunction joystick_function_;
+};
+
+// Whether scancode is down, in replay while it's replaying and on the keyboard
+// otherwise. replay may be null.
+inline bool IsKeyDown(const InputReplay* replay, ugdk::input::Scancode scancode) {
+    if (replay && replay->is_replaying())
+        return replay->IsDown(scancode);
+    return ugdk::input::manager()->keyboard().IsDown(scancode);
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_INPUTRECORD_H_
@@ -0,0 +1,247 @@
+#ifndef UGDK_EXAMPLES_LABELBUFFER_H_
+#define UGDK_EXAMPLES_LABELBUFFER_H_
+
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/module.h>
+#include <ugdk/graphic/shaderprogram.h>
+#include <ugdk/graphic/textureunit.h>
+#include <ugdk/graphic/vertexdata.h>
+#include <ugdk/math/vector2D.h>
+#include <ugdk/structure/color.h>
+
+#include <examples/atlastext.h>
+#include <examples/profiler.h>
+#include <examples/quadbatch.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// Labels of up to capacity characters, like NumberLabel's text, kept in a vertex
+// buffer of their own and drawn from an AtlasFont with one draw call. Every label
+// owns a region of capacity quads, one per character, from Add until Remove. The
+// characters sit in cells as wide as the font's widest glyph, so changing one
+// character rewrites that quad only, and a frame in which no label changed
+// writes nothing.
+//
+// Set, Move, Add and Remove collect the quads to write, and the next Draw writes
+// them with the buffer mapped once. The buffer goes with the LabelBuffer, which
+// must be destroyed before the graphic module is.
+class LabelBuffer {
+  public:
+    typedef std::size_t Label;
+
+    // What Draw wrote to the vertex buffer since the stats were last reset.
+    struct Stats {
+        unsigned long long uploads;
+        unsigned long long written_glyphs;
+        unsigned long long written_bytes;
+    };
+
+    // Labels are placed so that the point align of their box, from (0, 0) for the
+    // top-left corner to (1, 1) for the bottom-right one, lands on their position.
+    LabelBuffer(std::shared_ptr<const AtlasFont> font, std::size_t capacity, const ugdk::Color& color,
+                const ugdk::math::Vector2D& align = ugdk::math::Vector2D(), std::size_t initial_labels = 64)
+        : font_(std::move(font))
+        , capacity_(std::max<std::size_t>(1, capacity))
+        , color_(color)
+        , cell_width_(0)
+        , align_(align)
+        , num_labels_(0)
+        , buffer_labels_(0)
+        , draw_calls_(0)
+        , stats_(Stats())
+    {
+        for (int c = 0; c < 128; ++c)
+            if (const GlyphMetrics* glyph = font_->glyph(static_cast<char>(c)))
+                cell_width_ = std::max(cell_width_, static_cast<int>(glyph->advance));
+        box_ = ugdk::math::Vector2D(cell_width_ * static_cast<double>(capacity_), font_->line_height());
+        Reserve(initial_labels);
+        shader_ = CreateColoredVertexShader();
+        if (!shader_)
+            std::fprintf(stderr, "LabelBuffer: unable to build the vertex color shader, drawing without colors.\n");
+    }
+
+    LabelBuffer(const LabelBuffer&) = delete;
+    LabelBuffer& operator=(const LabelBuffer&) = delete;
+
+    // Adds a blank label at position, in the canvas space Draw is called in.
+    Label Add(const ugdk::math::Vector2D& position) {
+        Label label;
+        if (!free_labels_.empty()) {
+            label = free_labels_.back();
+            free_labels_.pop_back();
+        } else {
+            label = num_labels_++;
+            Reserve(num_labels_);
+            text_.resize(num_labels_ * capacity_, ' ');
+            origins_.resize(num_labels_);
+            dirty_.resize(num_labels_ * capacity_, false);
+        }
+        std::fill(text_.begin() + label * capacity_, text_.begin() + (label + 1) * capacity_, ' ');
+        origins_[label] = Origin(position);
+        MarkLabel(label);
+        return label;
+    }
+
+    // Blanks the label's quads and gives its region to the next Add.
+    void Remove(Label label) {
+        std::fill(text_.begin() + label * capacity_, text_.begin() + (label + 1) * capacity_, ' ');
+        MarkLabel(label);
+        free_labels_.push_back(label);
+    }
+
+    // Rewrites every quad of the label, unless it's already at position.
+    void Move(Label label, const ugdk::math::Vector2D& position) {
+        ugdk::math::Vector2D origin = Origin(position);
+        if (origin.x == origins_[label].x && origin.y == origins_[label].y)
+            return;
+        origins_[label] = origin;
+        MarkLabel(label);
+    }
+
+    // Shows the first capacity characters of text, padded with spaces.
+    void Set(Label label, const char* text, std::size_t length) {
+        char* current = &text_[label * capacity_];
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            char c = i < length ? text[i] : ' ';
+            if (current[i] != c) {
+                current[i] = c;
+                Mark(label * capacity_ + i);
+            }
+        }
+    }
+
+    void Set(Label label, const std::string& text) {
+        Set(label, text.data(), text.size());
+    }
+
+    // Writes the changed quads, then draws every label, blank regions included, in
+    // the canvas' current space.
+    void Draw(ugdk::graphic::Canvas& canvas) {
+        draw_calls_ = 0;
+        Upload();
+        if (num_labels_ == 0)
+            return;
+
+        const ugdk::graphic::ShaderProgram* previous_shader = canvas.shader_program();
+        if (shader_)
+            canvas.ChangeShaderProgram(shader_.get());
+        ugdk::graphic::TextureUnit unit = ugdk::graphic::manager()->ReserveTextureUnit(font_->texture());
+        canvas.SendUniform("drawable_texture", unit);
+        canvas.SendVertexData(*vertexdata_, ugdk::graphic::VertexType::VERTEX, 0, 2);
+        canvas.SendVertexData(*vertexdata_, ugdk::graphic::VertexType::TEXTURE, 2 * sizeof(GLfloat), 2);
+        if (shader_)
+            canvas.SendVertexData(*vertexdata_, ugdk::graphic::VertexType::COLOR, 4 * sizeof(GLfloat), 4);
+        canvas.DrawArrays(ugdk::graphic::DrawMode::TRIANGLES(), 0,
+                          static_cast<int>(num_glyphs() * QuadBatch::VERTICES_PER_QUAD));
+        ++draw_calls_;
+        if (shader_)
+            canvas.ChangeShaderProgram(previous_shader);
+    }
+
+    // Quads drawn by Draw, one per character of every region.
+    std::size_t num_glyphs() const { return num_labels_ * capacity_; }
+    std::size_t draw_calls() const { return draw_calls_; }
+
+    const Stats& stats() const { return stats_; }
+    void ResetStats() { stats_ = Stats(); }
+
+  private:
+    // Grows the buffer to hold num_labels regions. Its contents are lost, so every
+    // quad in use is written again.
+    void Reserve(std::size_t num_labels) {
+        if (num_labels <= buffer_labels_)
+            return;
+        buffer_labels_ = std::max(num_labels, 2 * buffer_labels_);
+        vertexdata_.reset(new ugdk::graphic::VertexData(buffer_labels_ * capacity_ * QuadBatch::VERTICES_PER_QUAD,
+                                                        sizeof(ColoredVertex), true));
+        dirty_quads_.reserve(buffer_labels_ * capacity_);
+        // Add marks the label it's growing the buffer for.
+        for (Label label = 0; label + 1 < num_labels_; ++label)
+            MarkLabel(label);
+    }
+
+    void Mark(std::size_t quad) {
+        if (!dirty_[quad]) {
+            dirty_[quad] = true;
+            dirty_quads_.push_back(quad);
+        }
+    }
+
+    void MarkLabel(Label label) {
+        for (std::size_t i = 0; i < capacity_; ++i)
+            Mark(label * capacity_ + i);
+    }
+
+    ugdk::math::Vector2D Origin(const ugdk::math::Vector2D& position) const {
+        return position - box_.Scale(align_);
+    }
+
+    void Upload() {
+        if (dirty_quads_.empty())
+            return;
+        EXAMPLES_PROFILE_SCOPE("label buffer upload");
+        {
+            ugdk::graphic::VertexData::Mapper mapper(*vertexdata_);
+            for (std::size_t quad : dirty_quads_) {
+                WriteQuad(mapper, quad);
+                dirty_[quad] = false;
+            }
+        }
+        stats_.uploads += 1;
+        stats_.written_glyphs += dirty_quads_.size();
+        stats_.written_bytes += dirty_quads_.size() * QuadBatch::VERTICES_PER_QUAD * sizeof(ColoredVertex);
+        dirty_quads_.clear();
+    }
+
+    // Blank characters, and those the font has no glyph for, get an empty quad.
+    void WriteQuad(ugdk::graphic::VertexData::Mapper& mapper, std::size_t quad) {
+        std::size_t v = quad * QuadBatch::VERTICES_PER_QUAD;
+        const GlyphMetrics* glyph = font_->glyph(text_[quad]);
+        if (!glyph || glyph->width == 0 || glyph->height == 0) {
+            for (std::size_t i = 0; i < QuadBatch::VERTICES_PER_QUAD; ++i)
+                mapper.Get<ColoredVertex>(v + i)->set(0.0f, 0.0f, 0.0f, 0.0f, color_);
+            return;
+        }
+        const ugdk::math::Vector2D& origin = origins_[quad / capacity_];
+        float x = static_cast<float>(origin.x + (quad % capacity_) * cell_width_ + glyph->bearing_x);
+        float y = static_cast<float>(origin.y + font_->ascent() - glyph->bearing_y);
+        float x2 = x + glyph->width, y2 = y + glyph->height;
+        TextureRegion r = font_->Region(*glyph);
+        mapper.Get<ColoredVertex>(v++)->set(x,  y,  r.u0, r.v0, color_);
+        mapper.Get<ColoredVertex>(v++)->set(x2, y,  r.u1, r.v0, color_);
+        mapper.Get<ColoredVertex>(v++)->set(x,  y2, r.u0, r.v1, color_);
+        mapper.Get<ColoredVertex>(v++)->set(x2, y,  r.u1, r.v0, color_);
+        mapper.Get<ColoredVertex>(v++)->set(x2, y2, r.u1, r.v1, color_);
+        mapper.Get<ColoredVertex>(v++)->set(x,  y2, r.u0, r.v1, color_);
+    }
+
+    std::shared_ptr<const AtlasFont> font_;
+    std::size_t capacity_;
+    ugdk::Color color_;
+    int cell_width_;
+    ugdk::math::Vector2D box_, align_;
+
+    std::size_t num_labels_, buffer_labels_;
+    std::vector<char> text_;
+    std::vector<ugdk::math::Vector2D> origins_;
+    std::vector<Label> free_labels_;
+    // A quad is in dirty_quads_ exactly when its flag is set.
+    std::vector<bool> dirty_;
+    std::vector<std::size_t> dirty_quads_;
+
+    std::unique_ptr<ugdk::graphic::ShaderProgram> shader_;
+    std::unique_ptr<ugdk::graphic::VertexData> vertexdata_;
+    std::size_t draw_calls_;
+    Stats stats_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_LABELBUFFER_H_
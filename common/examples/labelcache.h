@@ -0,0 +1,82 @@
+#ifndef UGDK_EXAMPLES_LABELCACHE_H_
+#define UGDK_EXAMPLES_LABELCACHE_H_
+
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/geometry.h>
+#include <ugdk/text/font.h>
+#include <ugdk/text/label.h>
+#include <ugdk/ui/drawable.h>
+
+#include <examples/poolresource.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace examples {
+
+// Drawable that draws a text::Label owned by someone else, so many nodes can show
+// the same label. It has its own hotspot; the shared label's hotspot is left at
+// the top-left corner.
+class SharedLabel : public ugdk::ui::Drawable {
+  public:
+    explicit SharedLabel(std::shared_ptr<const ugdk::text::Label> label)
+        : label_(std::move(label))
+    {}
+
+    void Draw(ugdk::graphic::Canvas& canvas) const override {
+        canvas.PushAndCompose(ugdk::graphic::Geometry(hotspot() * -1.0));
+        label_->Draw(canvas);
+        canvas.PopGeometry();
+    }
+
+    const ugdk::math::Vector2D& size() const override {
+        return label_->size();
+    }
+
+    const std::shared_ptr<const ugdk::text::Label>& label() const { return label_; }
+
+  private:
+    std::shared_ptr<const ugdk::text::Label> label_;
+};
+
+// Interns labels by font and message. Every glyph of a font already lives in that
+// font's atlas texture, so the labels only own their vertex buffers; with the
+// cache, identical strings share a single one.
+//
+// Labels stay alive while the cache or any SharedLabel references them. Every node
+// still draws its label on its own; text that should take a single draw call goes
+// through an examples::AtlasFont instead.
+class LabelCache {
+  public:
+    std::shared_ptr<const ugdk::text::Label> Get(const std::string& message, ugdk::text::Font* font) {
+        auto& label = labels_[std::make_pair(font, message)];
+        if (!label)
+            label = std::make_shared<ugdk::text::Label>(message, font);
+        return label;
+    }
+
+    std::unique_ptr<SharedLabel> MakeDrawable(const std::string& message, ugdk::text::Font* font) {
+        return MakePooledUnique<SharedLabel>(Get(message, font));
+    }
+
+    // Drops the labels no drawable uses anymore.
+    void Prune() {
+        for (auto it = labels_.begin(); it != labels_.end(); ) {
+            if (it->second.use_count() == 1)
+                it = labels_.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    std::size_t size() const { return labels_.size(); }
+
+  private:
+    std::map<std::pair<ugdk::text::Font*, std::string>, std::shared_ptr<const ugdk::text::Label>> labels_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_LABELCACHE_H_
@@ -0,0 +1,99 @@
+#ifndef UGDK_EXAMPLES_LOADINGSCENE_H_
+#define UGDK_EXAMPLES_LOADINGSCENE_H_
+
+#include <ugdk/system/engine.h>
+#include <ugdk/system/compatibility.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/module.h>
+#include <ugdk/ui/drawable/texturedrectangle.h>
+
+#include <examples/assetloader.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+namespace examples {
+
+// Measures the time from its construction, at the start of main, to the first
+// frame rendered by a scene.
+class StartupTimer {
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef std::function<void (ugdk::graphic::Canvas&)> RenderFunction;
+
+    StartupTimer() : start_(Clock::now()) {}
+
+    double elapsed_ms() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start_).count();
+    }
+
+    // Wraps a render function so the time of its first call is printed.
+    RenderFunction FirstFrame(const RenderFunction& render) const {
+        auto first = std::make_shared<bool>(true);
+        const StartupTimer* timer = this;
+        return [render, first, timer](ugdk::graphic::Canvas& canvas) {
+            if (render)
+                render(canvas);
+            if (*first) {
+                *first = false;
+                std::printf("Time to first frame: %.1f ms\n", timer->elapsed_ms());
+            }
+        };
+    }
+
+  private:
+    Clock::time_point start_;
+};
+
+// Shows a progress bar while the loader finishes its assets, spending at most
+// budget_ms of each frame on finish steps, and then replaces itself with the
+// scene returned by create_scene. If every asset is already loaded, as with
+// --sync-loading, the scene is created and pushed right away.
+inline void PushLoadingScene(AssetLoader& loader, const std::function<std::unique_ptr<ugdk::action::Scene> ()>& create_scene,
+                             double budget_ms = 4.0) {
+    if (loader.done()) {
+        std::printf("Loaded %u assets in %.1f ms, before the first frame\n",
+                    static_cast<unsigned>(loader.num_requested()), loader.loading_ms());
+        ugdk::system::PushScene(create_scene());
+        return;
+    }
+
+    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    auto frames = std::make_shared<unsigned>(0);
+    scene->AddTask([&loader, create_scene, budget_ms, frames](double) {
+        loader.Update(budget_ms);
+        if (!loader.done())
+            return;
+        std::printf("Loaded %u assets in %.1f ms, over %u loading frames\n",
+                    static_cast<unsigned>(loader.num_requested()), loader.loading_ms(), *frames);
+        ugdk::system::CurrentScene().Finish();
+        ugdk::system::PushScene(create_scene());
+    });
+
+    auto bar = std::make_shared<ugdk::ui::TexturedRectangle>(ugdk::graphic::manager()->white_texture(),
+                                                             ugdk::math::Vector2D(1.0, 1.0));
+    scene->set_render_function([&loader, bar, frames](ugdk::graphic::Canvas& canvas) {
+        ++*frames;
+        ugdk::math::Vector2D size(canvas.size().x * 0.6, 20.0);
+        ugdk::math::Vector2D position = (canvas.size() - size) * 0.5;
+
+        canvas.PushAndCompose(ugdk::graphic::VisualEffect(ugdk::Color(0.3, 0.3, 0.3)));
+        canvas.PushAndCompose(ugdk::graphic::Geometry(position, size));
+        bar->Draw(canvas);
+        canvas.PopGeometry();
+        canvas.PopVisualEffect();
+
+        ugdk::math::Vector2D filled(size.x * loader.progress(), size.y);
+        canvas.PushAndCompose(ugdk::graphic::Geometry(position, filled));
+        bar->Draw(canvas);
+        canvas.PopGeometry();
+    });
+    ugdk::system::PushScene(std::move(scene));
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_LOADINGSCENE_H_
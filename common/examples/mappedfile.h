@@ -0,0 +1,109 @@
+#ifndef UGDK_EXAMPLES_MAPPEDFILE_H_
+#define UGDK_EXAMPLES_MAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace examples {
+
+// Read-only memory mapping of a whole file. Pages are only loaded when touched,
+// so opening a large file costs the same as opening a small one.
+class MappedFile {
+  public:
+    MappedFile()
+        : data_(nullptr)
+        , size_(0)
+#ifdef _WIN32
+        , file_(INVALID_HANDLE_VALUE)
+        , mapping_(nullptr)
+#endif
+    {}
+
+    explicit MappedFile(const std::string& path) : MappedFile() {
+        Open(path);
+    }
+
+    ~MappedFile() {
+        Close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file can't be opened. Empty files can't be mapped either.
+    bool Open(const std::string& path) {
+        Close();
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0) {
+            Close();
+            return false;
+        }
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* data = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!data) {
+            Close();
+            return false;
+        }
+        size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return false;
+        }
+        void* data = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+            return false;
+        size_ = static_cast<std::size_t>(st.st_size);
+#endif
+        data_ = static_cast<const char*>(data);
+        return true;
+    }
+
+    void Close() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        mapping_ = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (data_) munmap(const_cast<char*>(data_), size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    bool is_open() const { return data_ != nullptr; }
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+  private:
+    const char* data_;
+    std::size_t size_;
+#ifdef _WIN32
+    HANDLE file_;
+    HANDLE mapping_;
+#endif
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_MAPPEDFILE_H_
@@ -0,0 +1,93 @@
+#ifndef UGDK_EXAMPLES_MEMORYOVERLAY_H_
+#define UGDK_EXAMPLES_MEMORYOVERLAY_H_
+
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/geometry.h>
+#include <ugdk/math/vector2D.h>
+#include <ugdk/text/font.h>
+#include <ugdk/text/label.h>
+
+#include <examples/allocationcounter.h>
+#include <examples/processmemory.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace examples {
+
+// Reads:
+//   --memory-overlay  show the memory of every module in the bottom-left corner
+//   --memory-report   print the memory of every module when the program exits
+// Both need a source file that defines EXAMPLES_ALLOCATION_COUNTER_IMPLEMENTATION.
+struct MemoryOverlayOptions {
+    MemoryOverlayOptions() : overlay(false), report_at_exit(false) {}
+
+    bool overlay;
+    bool report_at_exit;
+};
+
+inline MemoryOverlayOptions ParseMemoryOverlayOptions(int argc, char* argv[]) {
+    MemoryOverlayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--memory-overlay") == 0)
+            options.overlay = true;
+        else if (std::strcmp(argv[i], "--memory-report") == 0)
+            options.report_at_exit = true;
+    }
+    return options;
+}
+
+// Draws CurrentMemoryStats of every tag, and the process RSS, refreshed twice a
+// second. Its own labels are accounted to MemoryTag::OTHER. It must be destroyed
+// before the text module is, so it's best owned by the scene's render function.
+class MemoryOverlay {
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit MemoryOverlay(ugdk::text::Font* font)
+        : font_(font)
+    {}
+
+    void Draw(ugdk::graphic::Canvas& canvas) {
+        Clock::time_point now = Clock::now();
+        if (labels_.empty() || now - last_update_ >= std::chrono::milliseconds(500)) {
+            last_update_ = now;
+            Update();
+        }
+        double y = canvas.size().y - 5.0;
+        for (auto it = labels_.rbegin(); it != labels_.rend(); ++it) {
+            y -= (*it)->height();
+            canvas.PushAndCompose(ugdk::graphic::Geometry(ugdk::math::Vector2D(5.0, y)));
+            (*it)->Draw(canvas);
+            canvas.PopGeometry();
+        }
+    }
+
+  private:
+    void Update() {
+        MemoryTagScope tag(MemoryTag::OTHER);
+        labels_.clear();
+        char line[128];
+        std::snprintf(line, sizeof(line), "%-10s %10s %10s %8s", "module", "KiB", "peak KiB", "objects");
+        labels_.emplace_back(new ugdk::text::Label(line, font_));
+        for (std::size_t i = 0; i < NUM_MEMORY_TAGS; ++i) {
+            MemoryTagStats stats = CurrentMemoryStats(static_cast<MemoryTag>(i));
+            std::snprintf(line, sizeof(line), "%-10s %10.1f %10.1f %8llu", MemoryTagName(static_cast<MemoryTag>(i)),
+                          stats.current_bytes / 1024.0, stats.peak_bytes / 1024.0, stats.live_objects);
+            labels_.emplace_back(new ugdk::text::Label(line, font_));
+        }
+        std::snprintf(line, sizeof(line), "%-10s %10.1f", "rss", ResidentSetSize() / 1024.0);
+        labels_.emplace_back(new ugdk::text::Label(line, font_));
+    }
+
+    ugdk::text::Font* font_;
+    std::vector<std::unique_ptr<ugdk::text::Label>> labels_;
+    Clock::time_point last_update_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_MEMORYOVERLAY_H_
@@ -0,0 +1,115 @@
+#ifndef UGDK_EXAMPLES_MPSCQUEUE_H_
+#define UGDK_EXAMPLES_MPSCQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace examples {
+
+// Bounded lock-free queue with any number of producer threads and a single
+// consumer thread, based on Dmitry Vyukov's bounded queue. Each cell carries a
+// sequence number that tells producers and the consumer whose turn it is, so
+// pushing is a single compare-and-swap and popping needs no atomic RMW at all.
+//
+// Memory is allocated once, in the constructor. Values are constructed in place,
+// so T doesn't need a default constructor.
+template<typename T>
+class MPSCQueue {
+  public:
+    // capacity is rounded up to a power of two.
+    explicit MPSCQueue(std::size_t capacity)
+        : mask_(RoundUp(capacity) - 1)
+        , cells_(new Cell[mask_ + 1])
+        , enqueue_pos_(0)
+        , dequeue_pos_(0)
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    ~MPSCQueue() {
+        while (Pop([](const T&) {})) {}
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+    // May be called from any thread. Returns false if the queue is full.
+    bool TryPush(const T& value) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    new (&cell.storage) T(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Must only be called from the consumer thread. Calls function with the oldest
+    // value and removes it. Returns false if the queue is empty.
+    template<typename Function>
+    bool Pop(Function function) {
+        Cell& cell = cells_[dequeue_pos_ & mask_];
+        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeue_pos_ + 1)
+            return false;
+        T* value = reinterpret_cast<T*>(&cell.storage);
+        function(static_cast<const T&>(*value));
+        value->~T();
+        cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+    // Pops at most max_count values, calling function for each. Only values pushed
+    // before the call are popped, so busy producers can't keep the consumer here.
+    template<typename Function>
+    std::size_t Drain(Function function, std::size_t max_count) {
+        std::size_t end = enqueue_pos_.load(std::memory_order_acquire);
+        std::size_t count = 0;
+        while (count < max_count && dequeue_pos_ != end && Pop(function))
+            ++count;
+        return count;
+    }
+
+  private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+    };
+
+    static std::size_t RoundUp(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    // Producers and the consumer each get their own cache line. Padding rather than
+    // alignas, so queues can be allocated with new before C++17.
+    char before_enqueue_[64];
+    std::atomic<std::size_t> enqueue_pos_;
+    char after_enqueue_[64 - sizeof(std::atomic<std::size_t>)];
+    std::size_t dequeue_pos_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_MPSCQUEUE_H_
@@ -0,0 +1,84 @@
+#ifndef UGDK_EXAMPLES_NUMBERLABEL_H_
+#define UGDK_EXAMPLES_NUMBERLABEL_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+
+namespace examples {
+
+// The characters NumberLabel::Set writes, besides those of its suffix.
+const char NUMBER_LABEL_CHARSET[] = " 0123456789-.";
+
+// Up to capacity characters of a number, right-aligned and padded with spaces, so
+// with a monospaced font its digits don't jump around. The character buffer is
+// allocated by the constructor, so setting a new value allocates nothing.
+//
+// It draws nothing itself: text() is given to a LabelBuffer, which rewrites only
+// the glyphs of the characters that changed.
+class NumberLabel {
+  public:
+    explicit NumberLabel(std::size_t capacity)
+        : text_(capacity, ' ')
+    {}
+
+    // Shows value with the given number of decimals, 0 to 9, followed by suffix.
+    void Set(double value, int decimals = 0, const char* suffix = "") {
+        char buffer[64];
+        std::size_t length = Format(value, decimals, suffix, buffer, sizeof(buffer));
+        SetText(buffer, length);
+    }
+
+    // Shows the last characters of text that fit, right-aligned.
+    void SetText(const char* text, std::size_t length) {
+        std::size_t capacity = text_.size();
+        if (length > capacity) {
+            text += length - capacity;
+            length = capacity;
+        }
+        for (std::size_t i = 0; i < capacity; ++i)
+            text_[i] = i < capacity - length ? ' ' : text[i - (capacity - length)];
+    }
+
+    const std::string& text() const { return text_; }
+
+    // Writes value into out without allocating, returning the length. Values that
+    // don't fit in a long long, and NaN, are written as "-".
+    static std::size_t Format(double value, int decimals, const char* suffix, char* out, std::size_t out_size) {
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+        decimals = std::max(0, std::min(decimals, 9));
+        char digits[32];
+        std::size_t num_digits = 0;
+        bool negative = value < 0.0;
+        double scaled = std::floor(std::fabs(value) * powers[decimals] + 0.5);
+        if (!(scaled < 9e18)) {
+            digits[num_digits++] = '-';
+        } else {
+            unsigned long long n = static_cast<unsigned long long>(scaled);
+            negative = negative && n != 0;
+            for (int d = 0; d < decimals || n > 0 || num_digits <= static_cast<std::size_t>(decimals); ++d) {
+                if (d == decimals && decimals > 0)
+                    digits[num_digits++] = '.';
+                digits[num_digits++] = static_cast<char>('0' + n % 10);
+                n /= 10;
+            }
+            if (negative)
+                digits[num_digits++] = '-';
+        }
+        std::size_t length = 0;
+        while (num_digits > 0 && length + 1 < out_size)
+            out[length++] = digits[--num_digits];
+        for (; *suffix && length + 1 < out_size; ++suffix)
+            out[length++] = *suffix;
+        out[length] = '\0';
+        return length;
+    }
+
+  private:
+    std::string text_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_NUMBERLABEL_H_
@@ -0,0 +1,185 @@
+#ifndef UGDK_EXAMPLES_PARALLELTASKS_H_
+#define UGDK_EXAMPLES_PARALLELTASKS_H_
+
+#include <examples/workstealingpool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace examples {
+
+// A set of tasks that runs on a WorkStealingPool, meant to be a single scene task.
+//
+// Tasks added with the data they read and write may run at the same time as any
+// task they don't conflict with; two tasks conflict when one writes something the
+// other reads or writes, and then they run in the order they were added. Data is
+// named by its address. Tasks added without declaring anything keep the usual
+// scene task behaviour: they run on the main thread, after every task added before
+// them and before every task added after them.
+//
+// Usage:
+//   examples::WorkStealingPool pool(std::thread::hardware_concurrency() - 1);
+//   examples::ParallelTaskGroup tasks(pool);
+//   tasks.Add(UpdatePhysics, {&input}, {&positions});
+//   tasks.Add(UpdateAnimations, {}, {&animations});
+//   tasks.Add(PlaySounds);
+//   scene->AddTask([&tasks](double dt) { tasks.Run(dt); });
+class ParallelTaskGroup {
+  public:
+    typedef std::function<void (double)> TaskFunction;
+    typedef std::vector<const void*> DataList;
+
+    explicit ParallelTaskGroup(WorkStealingPool& pool)
+        : pool_(pool)
+        , last_barrier_(NONE)
+        , remaining_tasks_(0)
+        , dt_(0.0)
+    {}
+
+    void Add(const TaskFunction& function, const DataList& reads, const DataList& writes) {
+        std::size_t index = tasks_.size();
+        tasks_.emplace_back(new Task(function, false));
+        std::vector<std::size_t> dependencies;
+        if (last_barrier_ != NONE)
+            dependencies.push_back(last_barrier_);
+        for (const void* data : reads) {
+            const DataState& state = data_[data];
+            if (state.last_writer != NONE)
+                dependencies.push_back(state.last_writer);
+        }
+        for (const void* data : writes) {
+            const DataState& state = data_[data];
+            if (state.last_writer != NONE)
+                dependencies.push_back(state.last_writer);
+            dependencies.insert(dependencies.end(), state.readers.begin(), state.readers.end());
+        }
+        for (const void* data : reads)
+            data_[data].readers.push_back(index);
+        for (const void* data : writes) {
+            data_[data].last_writer = index;
+            data_[data].readers.clear();
+        }
+        since_barrier_.push_back(index);
+        Link(dependencies, index);
+    }
+
+    // Adds a task that runs on the main thread, in order with every other task.
+    void Add(const TaskFunction& function) {
+        std::size_t index = tasks_.size();
+        tasks_.emplace_back(new Task(function, true));
+        std::vector<std::size_t> dependencies(since_barrier_);
+        if (last_barrier_ != NONE)
+            dependencies.push_back(last_barrier_);
+        Link(dependencies, index);
+        // Everything after this depends on it, so the earlier accesses don't matter.
+        last_barrier_ = index;
+        since_barrier_.clear();
+        data_.clear();
+    }
+
+    // Runs every task once and returns when all are done. The calling thread runs
+    // the main thread tasks and helps the pool with the others.
+    void Run(double dt) {
+        if (tasks_.empty())
+            return;
+        dt_ = dt;
+        remaining_tasks_.store(tasks_.size(), std::memory_order_relaxed);
+        for (auto& task : tasks_)
+            task->remaining_dependencies.store(task->num_dependencies, std::memory_order_relaxed);
+        for (std::size_t i = 0; i < tasks_.size(); ++i)
+            if (tasks_[i]->num_dependencies == 0)
+                Schedule(i);
+
+        while (remaining_tasks_.load(std::memory_order_acquire) > 0) {
+            std::size_t main_task = NONE;
+            {
+                std::lock_guard<std::mutex> lock(main_mutex_);
+                if (!main_ready_.empty()) {
+                    main_task = main_ready_.back();
+                    main_ready_.pop_back();
+                }
+            }
+            if (main_task != NONE)
+                Execute(main_task);
+            else if (!pool_.RunOne())
+                std::this_thread::yield();
+        }
+    }
+
+    std::size_t size() const { return tasks_.size(); }
+
+  private:
+    static const std::size_t NONE = static_cast<std::size_t>(-1);
+
+    struct Task {
+        Task(const TaskFunction& function, bool main_thread)
+            : function(function)
+            , main_thread(main_thread)
+            , num_dependencies(0)
+            , remaining_dependencies(0)
+        {}
+
+        TaskFunction function;
+        bool main_thread;
+        std::vector<std::size_t> dependents;
+        unsigned num_dependencies;
+        std::atomic<unsigned> remaining_dependencies;
+    };
+
+    struct DataState {
+        DataState() : last_writer(NONE) {}
+        std::size_t last_writer;
+        std::vector<std::size_t> readers;
+    };
+
+    void Link(std::vector<std::size_t>& dependencies, std::size_t index) {
+        std::sort(dependencies.begin(), dependencies.end());
+        dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+        for (std::size_t dependency : dependencies)
+            tasks_[dependency]->dependents.push_back(index);
+        tasks_[index]->num_dependencies = static_cast<unsigned>(dependencies.size());
+    }
+
+    void Schedule(std::size_t index) {
+        if (tasks_[index]->main_thread) {
+            std::lock_guard<std::mutex> lock(main_mutex_);
+            main_ready_.push_back(index);
+        } else {
+            pool_.Submit([this, index] { Execute(index); });
+        }
+    }
+
+    void Execute(std::size_t index) {
+        Task& task = *tasks_[index];
+        task.function(dt_);
+        for (std::size_t dependent : task.dependents)
+            if (tasks_[dependent]->remaining_dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                Schedule(dependent);
+        remaining_tasks_.fetch_sub(1, std::memory_order_release);
+    }
+
+    WorkStealingPool& pool_;
+    std::vector<std::unique_ptr<Task>> tasks_;
+
+    // Used while adding tasks, to find their dependencies.
+    std::map<const void*, DataState> data_;
+    std::vector<std::size_t> since_barrier_;
+    std::size_t last_barrier_;
+
+    // State of the current Run.
+    std::atomic<std::size_t> remaining_tasks_;
+    std::mutex main_mutex_;
+    std::vector<std::size_t> main_ready_;
+    double dt_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_PARALLELTASKS_H_
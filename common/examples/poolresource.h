@@ -0,0 +1,197 @@
+#ifndef UGDK_EXAMPLES_POOLRESOURCE_H_
+#define UGDK_EXAMPLES_POOLRESOURCE_H_
+
+#include <examples/allocationcounter.h>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace examples {
+
+// Memory for the many small objects a scene creates and destroys, like nodes and
+// drawables. Sizes are rounded up to classes of GRANULARITY bytes, each with a free
+// list threaded through blocks carved from CHUNK_SIZE chunks. Freed blocks go back
+// to their class's list and are never returned to the system before the resource
+// is destroyed, so churn reuses the same memory instead of fragmenting the heap.
+//
+// Larger sizes go to the global operator new. The chunks are accounted to
+// MemoryTag::POOL whatever scope they're carved in, since they hold the objects of
+// every module; the larger sizes go to the current tag. Not thread-safe.
+class PoolResource {
+  public:
+    static const std::size_t GRANULARITY = 16;
+    static const std::size_t MAX_POOLED_SIZE = 512;
+    static const std::size_t CHUNK_SIZE = 64 * 1024;
+
+    PoolResource()
+        : free_lists_(MAX_POOLED_SIZE / GRANULARITY, nullptr)
+        , chunk_used_(CHUNK_SIZE)
+        , used_bytes_(0)
+        , allocations_(0)
+    {}
+
+    ~PoolResource() {
+        for (char* chunk : chunks_)
+            ::operator delete(chunk);
+    }
+
+    PoolResource(const PoolResource&) = delete;
+    PoolResource& operator=(const PoolResource&) = delete;
+
+    void* Allocate(std::size_t size) {
+        ++allocations_;
+        if (size > MAX_POOLED_SIZE || size == 0)
+            return ::operator new(size);
+        std::size_t index = (size - 1) / GRANULARITY;
+        used_bytes_ += (index + 1) * GRANULARITY;
+        if (FreeBlock* block = free_lists_[index]) {
+            free_lists_[index] = block->next;
+            return block;
+        }
+        return Carve((index + 1) * GRANULARITY);
+    }
+
+    // size must be the one given to Allocate.
+    void Deallocate(void* p, std::size_t size) {
+        if (!p)
+            return;
+        if (size > MAX_POOLED_SIZE || size == 0) {
+            ::operator delete(p);
+            return;
+        }
+        std::size_t index = (size - 1) / GRANULARITY;
+        used_bytes_ -= (index + 1) * GRANULARITY;
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = free_lists_[index];
+        free_lists_[index] = block;
+    }
+
+    // Bytes taken from the system, and how many of them are in live blocks.
+    std::size_t reserved_bytes() const { return chunks_.size() * CHUNK_SIZE; }
+    std::size_t used_bytes() const { return used_bytes_; }
+    unsigned long long allocations() const { return allocations_; }
+
+  private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    void* Carve(std::size_t block_size) {
+        if (chunk_used_ + block_size > CHUNK_SIZE) {
+            MemoryTagScope tag(MemoryTag::POOL);
+            chunks_.push_back(static_cast<char*>(::operator new(CHUNK_SIZE)));
+            chunk_used_ = 0;
+        }
+        void* block = chunks_.back() + chunk_used_;
+        chunk_used_ += block_size;
+        return block;
+    }
+
+    std::vector<FreeBlock*> free_lists_;
+    std::vector<char*> chunks_;
+    std::size_t chunk_used_;
+    std::size_t used_bytes_;
+    unsigned long long allocations_;
+};
+
+// The resource MakePooledShared and Pooled allocate from, usually set once per
+// scene. When it's null they use the global operator new.
+inline PoolResource*& CurrentPoolResource() {
+    static PoolResource* current = nullptr;
+    return current;
+}
+
+// Standard allocator over a PoolResource, for std::allocate_shared and containers.
+template<typename T>
+class PoolAllocator {
+  public:
+    typedef T value_type;
+
+    explicit PoolAllocator(PoolResource* resource) : resource_(resource) {}
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : resource_(other.resource()) {}
+
+    T* allocate(std::size_t n) {
+        if (!resource_)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(resource_->Allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) {
+        if (!resource_)
+            ::operator delete(p);
+        else
+            resource_->Deallocate(p, n * sizeof(T));
+    }
+
+    PoolResource* resource() const { return resource_; }
+
+    // Needed by pre-C++11 style allocator_traits of older standard libraries.
+    template<typename U>
+    struct rebind { typedef PoolAllocator<U> other; };
+
+  private:
+    PoolResource* resource_;
+};
+
+template<typename T, typename U>
+bool operator==(const PoolAllocator<T>& a, const PoolAllocator<U>& b) { return a.resource() == b.resource(); }
+template<typename T, typename U>
+bool operator!=(const PoolAllocator<T>& a, const PoolAllocator<U>& b) { return a.resource() != b.resource(); }
+
+// std::make_shared that allocates the object and its control block from the
+// current pool resource.
+template<typename T, typename... Args>
+std::shared_ptr<T> MakePooledShared(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(CurrentPoolResource()), std::forward<Args>(args)...);
+}
+
+// Base, allocated from the pool resource that was current when it was created.
+// For objects owned through a pointer to a base with a virtual destructor, like the
+// drawables owned by a ui::Node, which are deleted with plain delete.
+template<typename Base>
+class Pooled : public Base {
+  public:
+    template<typename... Args>
+    explicit Pooled(Args&&... args) : Base(std::forward<Args>(args)...) {}
+
+    static void* operator new(std::size_t size) {
+        PoolResource* resource = CurrentPoolResource();
+        std::size_t total = size + sizeof(Header);
+        void* p = resource ? resource->Allocate(total) : ::operator new(total);
+        Header* header = static_cast<Header*>(p);
+        header->resource = resource;
+        header->size = total;
+        return header + 1;
+    }
+
+    static void operator delete(void* p) {
+        if (!p)
+            return;
+        Header* header = static_cast<Header*>(p) - 1;
+        if (header->resource)
+            header->resource->Deallocate(header, header->size);
+        else
+            ::operator delete(header);
+    }
+
+  private:
+    // Remembers where the object came from. Its size keeps the object 16-byte aligned.
+    struct alignas(16) Header {
+        PoolResource* resource;
+        std::size_t size;
+    };
+};
+
+// MakeUnique for Pooled objects.
+template<typename T, typename... Args>
+std::unique_ptr<T> MakePooledUnique(Args&&... args) {
+    return std::unique_ptr<T>(new Pooled<T>(std::forward<Args>(args)...));
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_POOLRESOURCE_H_
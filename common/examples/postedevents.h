@@ -0,0 +1,71 @@
+#ifndef UGDK_EXAMPLES_POSTEDEVENTS_H_
+#define UGDK_EXAMPLES_POSTEDEVENTS_H_
+
+#include <ugdk/action/scene.h>
+
+#include <examples/mpscqueue.h>
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+namespace examples {
+
+// Lets any thread post events of type Event, which are raised on the main thread
+// once per frame, on the event handler given to Attach. Listeners added with
+// AddListener or AddObjectListener see them like any other event.
+//
+// Posting never blocks nor allocates. When more than capacity events are waiting
+// the new ones are dropped and counted.
+template<typename Event>
+class PostedEvents {
+  public:
+    explicit PostedEvents(std::size_t capacity = 4096)
+        : queue_(capacity)
+        , dropped_(0)
+        , max_per_frame_(std::numeric_limits<std::size_t>::max())
+    {}
+
+    // Thread-safe.
+    bool Post(const Event& ev) {
+        if (queue_.TryPush(ev))
+            return true;
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Adds a task to scene that raises the pending events on handler. Since tasks run
+    // on the main thread, listeners don't need to be thread-safe.
+    void Attach(ugdk::action::Scene& scene, ugdk::system::EventHandler& handler) {
+        ugdk::system::EventHandler* target = &handler;
+        scene.AddTask([this, target](double) {
+            Drain(*target);
+        });
+    }
+
+    void Attach(ugdk::action::Scene& scene) {
+        Attach(scene, scene.event_handler());
+    }
+
+    // Raises at most max_per_frame() events on handler. Main thread only.
+    std::size_t Drain(ugdk::system::EventHandler& handler) {
+        return queue_.Drain([&handler](const Event& ev) { handler.RaiseEvent(ev); }, max_per_frame_);
+    }
+
+    // Limits how many events are raised each frame, spreading bursts over
+    // several frames. Unlimited by default.
+    void set_max_per_frame(std::size_t max) { max_per_frame_ = max; }
+    std::size_t max_per_frame() const { return max_per_frame_; }
+
+    std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    std::size_t capacity() const { return queue_.capacity(); }
+
+  private:
+    MPSCQueue<Event> queue_;
+    std::atomic<std::size_t> dropped_;
+    std::size_t max_per_frame_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_POSTEDEVENTS_H_
@@ -0,0 +1,56 @@
+#ifndef UGDK_EXAMPLES_PROCESSMEMORY_H_
+#define UGDK_EXAMPLES_PROCESSMEMORY_H_
+
+#include <cstddef>
+#include <cstdio>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+#if defined __GLIBC__ && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define UGDK_EXAMPLES_HAS_MALLINFO2
+#endif
+
+namespace examples {
+
+// Resident set size of the process in bytes, or 0 where it isn't available.
+inline std::size_t ResidentSetSize() {
+#ifdef __linux__
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    unsigned long size = 0, resident = 0;
+    int read = std::fscanf(statm, "%lu %lu", &size, &resident);
+    std::fclose(statm);
+    if (read != 2)
+        return 0;
+    return static_cast<std::size_t>(resident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// Memory malloc holds from the system, and how much of it is allocated. The
+// difference is free memory the heap can't give back, mostly from fragmentation.
+struct HeapStats {
+    std::size_t reserved;
+    std::size_t in_use;
+
+    std::size_t free() const { return reserved - in_use; }
+};
+
+// Both are 0 where glibc's mallinfo2 isn't available.
+inline HeapStats CurrentHeapStats() {
+    HeapStats stats = { 0, 0 };
+#ifdef UGDK_EXAMPLES_HAS_MALLINFO2
+    struct mallinfo2 info = mallinfo2();
+    stats.reserved = info.arena + info.hblkhd;
+    stats.in_use = info.uordblks + info.hblkhd;
+#endif
+    return stats;
+}
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_PROCESSMEMORY_H_
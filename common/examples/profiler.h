@@ -0,0 +1,278 @@
+#ifndef UGDK_EXAMPLES_PROFILER_H_
+#define UGDK_EXAMPLES_PROFILER_H_
+
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/geometry.h>
+#include <ugdk/math/vector2D.h>
+#include <ugdk/text/font.h>
+#include <ugdk/text/label.h>
+
+#include <examples/clock.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Scoped timers for the frame profiler. They compile to nothing unless
+// UGDK_EXAMPLES_PROFILER is defined, which the UGDK_EXAMPLES_PROFILER CMake
+// option does for every example.
+//
+//   EXAMPLES_PROFILE_SCOPE("name")  times the rest of the enclosing block
+//   EXAMPLES_PROFILE_PHASE("name")  same, for the top-level phases of a frame; the
+//                                   time outside every phase is shown as "other"
+//
+// Names must be string literals, or otherwise live as long as the program.
+#define EXAMPLES_PROFILE_CONCAT_(a, b) a##b
+#define EXAMPLES_PROFILE_CONCAT(a, b) EXAMPLES_PROFILE_CONCAT_(a, b)
+#ifdef UGDK_EXAMPLES_PROFILER
+#define EXAMPLES_PROFILE_SCOPE(name) \
+    ::examples::ProfileScope EXAMPLES_PROFILE_CONCAT(examples_profile_scope_, __LINE__)(name, false)
+#define EXAMPLES_PROFILE_PHASE(name) \
+    ::examples::ProfileScope EXAMPLES_PROFILE_CONCAT(examples_profile_scope_, __LINE__)(name, true)
+#else
+#define EXAMPLES_PROFILE_SCOPE(name) do {} while (0)
+#define EXAMPLES_PROFILE_PHASE(name) do {} while (0)
+#endif
+
+namespace examples {
+
+// Collects the scopes of each frame, keeps rolling per-name averages for the HUD,
+// and keeps every scope for a Chrome trace_event JSON file, which chrome://tracing
+// and Perfetto open.
+//
+// Scopes may be recorded from any thread, but those on other threads must end
+// before the frame they belong to does.
+class Profiler {
+  public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Scopes kept per frame and, for the trace, in total. Extra ones are dropped.
+    static const std::size_t MAX_FRAME_EVENTS = 16384;
+    static const std::size_t MAX_TRACE_EVENTS = 4 * 1024 * 1024;
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    ~Profiler() {
+        WriteTrace();
+    }
+
+    static bool compiled_in() {
+#ifdef UGDK_EXAMPLES_PROFILER
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Where to write the trace when the program ends. Empty to write none.
+    void set_trace_path(const std::string& path) { trace_path_ = path; }
+
+    // The HUD is drawn with this font. Without one, the averages are printed to
+    // stdout once per second instead.
+    void set_font(ugdk::text::Font* font) { font_ = font; }
+    void set_hud_enabled(bool enabled) { hud_enabled_ = enabled; }
+
+    // Writes the trace and drops the HUD labels along with the font. The profiler
+    // outlives main, so examples that set a font call this before system::Release.
+    void Shutdown() {
+        WriteTrace();
+        hud_labels_.clear();
+        font_ = nullptr;
+    }
+
+    // Thread-safe.
+    void Record(const char* name, bool phase, Clock::time_point begin, Clock::time_point end) {
+        std::size_t index = num_frame_events_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= MAX_FRAME_EVENTS)
+            return;
+        Event& event = frame_events_[index];
+        event.name = name;
+        event.phase = phase;
+        event.thread = ThreadIndex();
+        event.begin_ns = Nanoseconds(begin);
+        event.end_ns = Nanoseconds(end);
+    }
+
+    // Ends the current frame and starts a new one. Called on the main thread.
+    void BeginFrame() {
+        Clock::time_point now = Clock::now();
+        std::size_t count = std::min(num_frame_events_.load(std::memory_order_acquire), MAX_FRAME_EVENTS);
+        if (frame_begin_ != Clock::time_point()) {
+            double frame_ms = Milliseconds(frame_begin_, now);
+            double phases_ms = 0.0;
+            for (Stat& stat : stats_)
+                stat.frame_ms = 0.0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const Event& event = frame_events_[i];
+                double ms = (event.end_ns - event.begin_ns) * 1e-6;
+                FindStat(event.name).frame_ms += ms;
+                if (event.phase)
+                    phases_ms += ms;
+            }
+            FindStat("frame").frame_ms = frame_ms;
+            FindStat("other").frame_ms = std::max(0.0, frame_ms - phases_ms);
+            for (Stat& stat : stats_)
+                stat.average_ms += (stat.frame_ms - stat.average_ms) * 0.05;
+
+            if (!trace_path_.empty()) {
+                std::size_t room = MAX_TRACE_EVENTS - std::min(trace_.size(), MAX_TRACE_EVENTS);
+                trace_.insert(trace_.end(), frame_events_.begin(), frame_events_.begin() + std::min(count, room));
+                if (room > 0) {
+                    Event frame = { "frame", false, ThreadIndex(), Nanoseconds(frame_begin_), Nanoseconds(now) };
+                    trace_.push_back(frame);
+                }
+            }
+            if (now - last_report_ >= std::chrono::milliseconds(250))
+                Report(now);
+        } else {
+            last_report_ = now;
+        }
+        num_frame_events_.store(0, std::memory_order_release);
+        frame_begin_ = now;
+    }
+
+    // Draws the rolling averages in the top-right corner of the canvas.
+    void DrawHUD(ugdk::graphic::Canvas& canvas) const {
+        if (!hud_enabled_ || !font_)
+            return;
+        double y = 5.0;
+        for (const auto& label : hud_labels_) {
+            canvas.PushAndCompose(ugdk::graphic::Geometry(ugdk::math::Vector2D(canvas.size().x - label->width() - 5.0, y)));
+            label->Draw(canvas);
+            canvas.PopGeometry();
+            y += label->height();
+        }
+    }
+
+    // Writes the scopes recorded so far. Called by Shutdown and the destructor.
+    void WriteTrace() {
+        if (trace_path_.empty() || trace_.empty())
+            return;
+        FILE* out = std::fopen(trace_path_.c_str(), "w");
+        if (!out) {
+            std::fprintf(stderr, "Unable to open '%s' for writing.\n", trace_path_.c_str());
+            return;
+        }
+        std::fprintf(out, "{\"traceEvents\":[\n");
+        for (std::size_t i = 0; i < trace_.size(); ++i) {
+            const Event& event = trace_[i];
+            std::fprintf(out, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                         event.name, event.phase ? "phase" : "scope", event.thread,
+                         (event.begin_ns - start_ns_) * 1e-3, (event.end_ns - event.begin_ns) * 1e-3,
+                         i + 1 < trace_.size() ? "," : "");
+        }
+        std::fprintf(out, "],\"displayTimeUnit\":\"ms\"}\n");
+        std::fclose(out);
+        std::printf("Wrote %u trace events to '%s'.\n", static_cast<unsigned>(trace_.size()), trace_path_.c_str());
+        trace_.clear();
+    }
+
+  private:
+    struct Event {
+        const char* name;
+        bool phase;
+        unsigned thread;
+        int64_t begin_ns, end_ns;
+    };
+
+    struct Stat {
+        const char* name;
+        double frame_ms, average_ms;
+    };
+
+    Profiler()
+        : frame_events_(MAX_FRAME_EVENTS)
+        , num_frame_events_(0)
+        , start_ns_(Nanoseconds(Clock::now()))
+        , next_thread_(0)
+        , font_(nullptr)
+        , hud_enabled_(false)
+    {}
+
+    static int64_t Nanoseconds(Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    // Small, stable thread numbers for the trace. The first thread to record is 0.
+    // Each thread takes its number once and keeps it, so recording takes no lock.
+    unsigned ThreadIndex() {
+        static thread_local unsigned index = next_thread_.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    Stat& FindStat(const char* name) {
+        for (Stat& stat : stats_)
+            if (stat.name == name || std::strcmp(stat.name, name) == 0)
+                return stat;
+        Stat stat = { name, 0.0, 0.0 };
+        stats_.push_back(stat);
+        return stats_.back();
+    }
+
+    void Report(Clock::time_point now) {
+        last_report_ = now;
+        std::vector<Stat> sorted(stats_);
+        std::sort(sorted.begin(), sorted.end(), [](const Stat& a, const Stat& b) { return a.average_ms > b.average_ms; });
+        if (hud_enabled_ && font_) {
+            hud_labels_.clear();
+            for (const Stat& stat : sorted) {
+                char line[128];
+                std::snprintf(line, sizeof(line), "%-16s %7.3f ms", stat.name, stat.average_ms);
+                hud_labels_.emplace_back(new ugdk::text::Label(line, font_));
+            }
+        } else if (hud_enabled_ && now - last_print_ >= std::chrono::seconds(1)) {
+            last_print_ = now;
+            std::printf("profile:");
+            for (const Stat& stat : sorted)
+                std::printf(" %s %.3f ms |", stat.name, stat.average_ms);
+            std::printf("\n");
+        }
+    }
+
+    std::vector<Event> frame_events_;
+    std::atomic<std::size_t> num_frame_events_;
+    std::vector<Event> trace_;
+    std::string trace_path_;
+    int64_t start_ns_;
+
+    std::atomic<unsigned> next_thread_;
+
+    std::vector<Stat> stats_;
+    Clock::time_point frame_begin_, last_report_, last_print_;
+
+    ugdk::text::Font* font_;
+    bool hud_enabled_;
+    std::vector<std::unique_ptr<ugdk::text::Label>> hud_labels_;
+};
+
+// Records the time between its construction and destruction.
+class ProfileScope {
+  public:
+    ProfileScope(const char* name, bool phase)
+        : name_(name)
+        , phase_(phase)
+        , begin_(Profiler::Clock::now())
+    {}
+
+    ~ProfileScope() {
+        Profiler::instance().Record(name_, phase_, begin_, Profiler::Clock::now());
+    }
+
+  private:
+    const char* name_;
+    bool phase_;
+    Profiler::Clock::time_point begin_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_PROFILER_H_
@@ -0,0 +1,220 @@
+#ifndef UGDK_EXAMPLES_QUADBATCH_H_
+#define UGDK_EXAMPLES_QUADBATCH_H_
+
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/module.h>
+#include <ugdk/graphic/shader.h>
+#include <ugdk/graphic/shaderprogram.h>
+#include <ugdk/graphic/vertexdata.h>
+#include <ugdk/graphic/textureunit.h>
+#include <ugdk/structure/color.h>
+#include <ugdk/math/vector2D.h>
+
+#include <examples/profiler.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace examples {
+
+// Vertex layout of QuadBatch: position, texture coordinates and color.
+struct ColoredVertex {
+    GLfloat x, y, u, v;
+    GLfloat r, g, b, a;
+
+    void set(float x_, float y_, float u_, float v_, const ugdk::Color& color) {
+        x = x_; y = y_; u = u_; v = v_;
+        r = static_cast<GLfloat>(color.r);
+        g = static_cast<GLfloat>(color.g);
+        b = static_cast<GLfloat>(color.b);
+        a = static_cast<GLfloat>(color.a);
+    }
+};
+
+// The part of a texture a quad shows, in texture coordinates.
+struct TextureRegion {
+    float u0, v0, u1, v1;
+
+    static TextureRegion Whole() {
+        TextureRegion region = { 0.0f, 0.0f, 1.0f, 1.0f };
+        return region;
+    }
+};
+
+// ugdk's default shader with the vertex color of a ColoredVertex multiplied into the
+// texture's, or null if it fails to build.
+inline std::unique_ptr<ugdk::graphic::ShaderProgram> CreateColoredVertexShader() {
+    ugdk::graphic::Shader vertex_shader(GL_VERTEX_SHADER), fragment_shader(GL_FRAGMENT_SHADER);
+    vertex_shader.AddCodeBlock("in vec4 vertexColor;\nout vec4 vertex_color;\n");
+    vertex_shader.AddLineInMain("    gl_Position = geometry_matrix * vec4(vertexPosition, 0.0, 1.0);\n");
+    vertex_shader.AddLineInMain("    UV = vertexUV;\n");
+    vertex_shader.AddLineInMain("    vertex_color = vertexColor;\n");
+    vertex_shader.GenerateSource();
+    fragment_shader.AddCodeBlock("in vec4 vertex_color;\n");
+    fragment_shader.AddLineInMain("    gl_FragColor = texture2D(drawable_texture, UV) * vertex_color * effect_color;\n");
+    fragment_shader.GenerateSource();
+
+    std::unique_ptr<ugdk::graphic::ShaderProgram> shader(new ugdk::graphic::ShaderProgram);
+    if (shader->AttachShader(vertex_shader) && shader->AttachShader(fragment_shader) && shader->SetupProgram())
+        return shader;
+    return std::unique_ptr<ugdk::graphic::ShaderProgram>();
+}
+
+// Collects textured, colored quads and draws every run of consecutive quads that
+// share the same texture with a single vertex buffer and draw call.
+//
+// Colors are carried per vertex and multiplied in by a shader of the batch's own,
+// built on ugdk's default one, so quads of any color share a draw call. If that
+// shader fails to build, quads are drawn with the default shader and no color.
+class QuadBatch {
+  public:
+    // Each quad is drawn as two triangles, since strips can't be merged.
+    static const std::size_t VERTICES_PER_QUAD = 6;
+
+    explicit QuadBatch(std::size_t initial_capacity = 1024)
+        : capacity_(0)
+        , draw_calls_(0)
+    {
+        Reserve(initial_capacity);
+        CreateShader();
+    }
+
+    void Reserve(std::size_t num_quads) {
+        if (num_quads <= capacity_)
+            return;
+        capacity_ = num_quads;
+        vertexdata_.reset(new ugdk::graphic::VertexData(capacity_ * VERTICES_PER_QUAD, sizeof(ColoredVertex), true));
+        quads_.reserve(capacity_);
+    }
+
+    // Removes all queued quads. The vertex buffer is kept for the next frame.
+    void Clear() {
+        quads_.clear();
+        runs_.clear();
+    }
+
+    // Queues a quad whose top-left corner is at position, in the canvas' current space,
+    // showing region of texture.
+    void Add(const ugdk::graphic::GLTexture* texture, const ugdk::math::Vector2D& position,
+             const ugdk::math::Vector2D& size, const ugdk::Color& color,
+             const TextureRegion& region = TextureRegion::Whole()) {
+        Quad quad = {
+            static_cast<float>(position.x), static_cast<float>(position.y),
+            static_cast<float>(size.x), static_cast<float>(size.y), region, color
+        };
+        StartRun(texture);
+        runs_.back().count += 1;
+        quads_.push_back(quad);
+    }
+
+    // Queues count quads of the same size, texture and color, with their top-left
+    // corners read from the xs and ys arrays.
+    void AddRun(const ugdk::graphic::GLTexture* texture, const ugdk::Color& color,
+                const float* xs, const float* ys, std::size_t count, const ugdk::math::Vector2D& size) {
+        if (count == 0)
+            return;
+        StartRun(texture);
+        runs_.back().count += count;
+        float w = static_cast<float>(size.x), h = static_cast<float>(size.y);
+        std::size_t first = quads_.size();
+        quads_.resize(first + count);
+        Quad* quads = quads_.data() + first;
+        for (std::size_t i = 0; i < count; ++i) {
+            quads[i].x = xs[i];
+            quads[i].y = ys[i];
+            quads[i].w = w;
+            quads[i].h = h;
+            quads[i].region = TextureRegion::Whole();
+            quads[i].color = color;
+        }
+    }
+
+    // Uploads every queued quad in one pass and issues one draw call per run.
+    void Draw(ugdk::graphic::Canvas& canvas) {
+        draw_calls_ = 0;
+        if (quads_.empty())
+            return;
+        Reserve(quads_.size());
+        {
+            EXAMPLES_PROFILE_SCOPE("quad batch upload");
+            Upload();
+        }
+
+        const ugdk::graphic::ShaderProgram* previous_shader = canvas.shader_program();
+        if (shader_)
+            canvas.ChangeShaderProgram(shader_.get());
+        for (const Run& run : runs_) {
+            ugdk::graphic::TextureUnit unit = ugdk::graphic::manager()->ReserveTextureUnit(run.texture);
+            canvas.SendUniform("drawable_texture", unit);
+            canvas.SendVertexData(*vertexdata_, ugdk::graphic::VertexType::VERTEX, 0, 2);
+            canvas.SendVertexData(*vertexdata_, ugdk::graphic::VertexType::TEXTURE, 2 * sizeof(GLfloat), 2);
+            if (shader_)
+                canvas.SendVertexData(*vertexdata_, ugdk::graphic::VertexType::COLOR, 4 * sizeof(GLfloat), 4);
+            canvas.DrawArrays(ugdk::graphic::DrawMode::TRIANGLES(),
+                              static_cast<int>(run.first * VERTICES_PER_QUAD),
+                              static_cast<int>(run.count * VERTICES_PER_QUAD));
+            ++draw_calls_;
+        }
+        if (shader_)
+            canvas.ChangeShaderProgram(previous_shader);
+    }
+
+    std::size_t size() const { return quads_.size(); }
+    std::size_t capacity() const { return capacity_; }
+
+    // Number of draw calls issued by the last call to Draw.
+    std::size_t draw_calls() const { return draw_calls_; }
+
+  private:
+    struct Quad {
+        float x, y, w, h;
+        TextureRegion region;
+        ugdk::Color color;
+    };
+
+    struct Run {
+        const ugdk::graphic::GLTexture* texture;
+        std::size_t first, count;
+    };
+
+    void StartRun(const ugdk::graphic::GLTexture* texture) {
+        if (runs_.empty() || runs_.back().texture != texture) {
+            Run run = { texture, quads_.size(), 0 };
+            runs_.push_back(run);
+        }
+    }
+
+    void CreateShader() {
+        shader_ = CreateColoredVertexShader();
+        if (!shader_)
+            std::fprintf(stderr, "QuadBatch: unable to build the vertex color shader, drawing without colors.\n");
+    }
+
+    void Upload() {
+        ugdk::graphic::VertexData::Mapper mapper(*vertexdata_, false);
+        std::size_t v = 0;
+        for (const Quad& q : quads_) {
+            float x2 = q.x + q.w, y2 = q.y + q.h;
+            const TextureRegion& r = q.region;
+            mapper.Get<ColoredVertex>(v++)->set(q.x, q.y, r.u0, r.v0, q.color);
+            mapper.Get<ColoredVertex>(v++)->set(x2,  q.y, r.u1, r.v0, q.color);
+            mapper.Get<ColoredVertex>(v++)->set(q.x, y2,  r.u0, r.v1, q.color);
+            mapper.Get<ColoredVertex>(v++)->set(x2,  q.y, r.u1, r.v0, q.color);
+            mapper.Get<ColoredVertex>(v++)->set(x2,  y2,  r.u1, r.v1, q.color);
+            mapper.Get<ColoredVertex>(v++)->set(q.x, y2,  r.u0, r.v1, q.color);
+        }
+    }
+
+    std::size_t capacity_;
+    std::size_t draw_calls_;
+    std::unique_ptr<ugdk::graphic::ShaderProgram> shader_;
+    std::unique_ptr<ugdk::graphic::VertexData> vertexdata_;
+    std::vector<Quad> quads_;
+    std::vector<Run> runs_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_QUADBATCH_H_
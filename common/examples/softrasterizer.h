@@ -0,0 +1,493 @@
+#ifndef UGDK_EXAMPLES_SOFTRASTERIZER_H_
+#define UGDK_EXAMPLES_SOFTRASTERIZER_H_
+
+#include <examples/workstealingpool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EXAMPLES_SOFTRASTERIZER_SSE2
+#include <emmintrin.h>
+#endif
+
+// The AVX2 spans are compiled with target attributes, like the batchtransform.h
+// paths, so they don't need -mavx2 and only run when the CPU supports them.
+#if defined(EXAMPLES_SOFTRASTERIZER_SSE2) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define EXAMPLES_SOFTRASTERIZER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace examples {
+
+// Pixels are 8-bit RGBA, stored in that byte order, so 0xAABBGGRR on little-endian.
+typedef uint32_t Pixel;
+
+inline Pixel PackPixel(double r, double g, double b, double a = 1.0) {
+    auto channel = [](double value) {
+        return static_cast<Pixel>(std::min(255.0, std::max(0.0, value * 255.0 + 0.5)));
+    };
+    return channel(r) | channel(g) << 8 | channel(b) << 16 | channel(a) << 24;
+}
+
+struct SoftTexture {
+    SoftTexture(int width, int height, Pixel fill = 0xFFFFFFFF)
+        : width(width), height(height), texels(static_cast<std::size_t>(width) * height, fill) {}
+
+    int width, height;
+    std::vector<Pixel> texels;
+};
+
+enum class SpanPath { SCALAR, SSE2, AVX2 };
+
+inline const char* SpanPathName(SpanPath path) {
+    switch (path) {
+    case SpanPath::SSE2: return "sse2";
+    case SpanPath::AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+inline bool SpanPathSupported(SpanPath path) {
+#ifdef EXAMPLES_SOFTRASTERIZER_AVX2
+    if (path == SpanPath::AVX2) {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    }
+#endif
+#ifdef EXAMPLES_SOFTRASTERIZER_SSE2
+    if (path == SpanPath::SSE2)
+        return true;
+#endif
+    return path == SpanPath::SCALAR;
+}
+
+inline SpanPath BestSpanPath() {
+    static const SpanPath best = SpanPathSupported(SpanPath::AVX2) ? SpanPath::AVX2
+                               : SpanPathSupported(SpanPath::SSE2) ? SpanPath::SSE2
+                               : SpanPath::SCALAR;
+    return best;
+}
+
+// 8-bit coverage, like a rasterized glyph.
+struct SoftMask {
+    SoftMask(int width, int height)
+        : width(width), height(height), coverage(static_cast<std::size_t>(width) * height, 0) {}
+
+    int width, height;
+    std::vector<uint8_t> coverage;
+};
+
+// Draws colored quads, textured quads and coverage masks into an in-memory RGBA
+// framebuffer, for rendering workloads on machines without a GPU.
+//
+// Draw calls only queue commands. Flush splits the framebuffer into bands of rows
+// and rasterizes every command clipped to each band on the worker threads, so
+// commands are always applied in order. Spans are filled and blended eight pixels
+// at a time with AVX2 or four at a time with SSE2, whichever the path allows; every
+// path gives the same pixels.
+//
+// This is not a backend for graphic::Canvas, which lives in the ugdk submodule and
+// needs a GL context, so the examples themselves still can't run headless.
+//
+// Quads are axis-aligned, cover the pixels whose centers they contain, and sample
+// textures with the nearest texel. Colors modulate textures and masks, and anything
+// not fully opaque is alpha blended.
+class SoftRasterizer {
+  public:
+    SoftRasterizer(int width, int height, unsigned num_threads = 1)
+        : width_(width)
+        , height_(height)
+        , pixels_(static_cast<std::size_t>(width) * height, 0)
+        , pool_(num_threads > 1 ? num_threads - 1 : 0)
+        , num_threads_(std::max(1u, num_threads))
+        , path_(BestSpanPath())
+        , pixels_drawn_(0)
+    {}
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    const std::vector<Pixel>& pixels() const { return pixels_; }
+    unsigned num_threads() const { return num_threads_; }
+
+    SpanPath path() const { return path_; }
+    // Unsupported paths fall back to the best supported one below them.
+    void set_path(SpanPath path) {
+        path_ = path == SpanPath::AVX2 && !SpanPathSupported(SpanPath::AVX2) ? SpanPath::SSE2 : path;
+        if (path_ == SpanPath::SSE2 && !SpanPathSupported(SpanPath::SSE2))
+            path_ = SpanPath::SCALAR;
+    }
+
+    // Pixels written by the last Flush, counting overdraw.
+    unsigned long long pixels_drawn() const { return pixels_drawn_; }
+
+    void Clear(Pixel color) {
+        Command command = Command();
+        command.type = CLEAR;
+        command.color = color;
+        commands_.push_back(command);
+    }
+
+    void FillQuad(double x, double y, double w, double h, Pixel color) {
+        Command command = MakeQuad(FILL, x, y, w, h, color);
+        commands_.push_back(command);
+    }
+
+    // The texture must live until the next Flush.
+    void DrawTexture(double x, double y, double w, double h, const SoftTexture& texture, Pixel color = 0xFFFFFFFF) {
+        Command command = MakeQuad(TEXTURE, x, y, w, h, color);
+        command.texture = &texture;
+        commands_.push_back(command);
+    }
+
+    // Draws the mask unscaled with its top-left corner at (x, y). The mask must live
+    // until the next Flush.
+    void DrawMask(double x, double y, const SoftMask& mask, Pixel color) {
+        Command command = MakeQuad(MASK, x, y, mask.width, mask.height, color);
+        command.mask = &mask;
+        commands_.push_back(command);
+    }
+
+    // Rasterizes every queued command and clears the queue.
+    void Flush() {
+        std::atomic<unsigned long long> drawn(0);
+        // A few bands per thread, so uneven bands balance out.
+        int num_bands = static_cast<int>(num_threads_ == 1 ? 1 : num_threads_ * 4);
+        int band_height = std::max(1, (height_ + num_bands - 1) / num_bands);
+        // With fewer rows than bands, the last bands would be empty.
+        num_bands = (height_ + band_height - 1) / band_height;
+        std::atomic<int> remaining(num_bands);
+        for (int band = 0; band < num_bands; ++band) {
+            int top = band * band_height, bottom = std::min(height_, top + band_height);
+            pool_.Submit([this, top, bottom, &drawn, &remaining] {
+                drawn.fetch_add(RasterizeBand(top, bottom), std::memory_order_relaxed);
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+        }
+        while (remaining.load(std::memory_order_acquire) > 0)
+            if (!pool_.RunOne())
+                std::this_thread::yield();
+        pixels_drawn_ = drawn.load();
+        commands_.clear();
+    }
+
+    // Writes the framebuffer as a binary PPM, dropping alpha.
+    bool WritePPM(const std::string& path) const {
+        FILE* out = std::fopen(path.c_str(), "wb");
+        if (!out) {
+            std::fprintf(stderr, "Unable to open '%s' for writing.\n", path.c_str());
+            return false;
+        }
+        std::fprintf(out, "P6\n%d %d\n255\n", width_, height_);
+        std::vector<uint8_t> row(static_cast<std::size_t>(width_) * 3);
+        for (int y = 0; y < height_; ++y) {
+            const Pixel* src = &pixels_[static_cast<std::size_t>(y) * width_];
+            for (int x = 0; x < width_; ++x) {
+                row[x * 3 + 0] = src[x] & 0xFF;
+                row[x * 3 + 1] = (src[x] >> 8) & 0xFF;
+                row[x * 3 + 2] = (src[x] >> 16) & 0xFF;
+            }
+            std::fwrite(row.data(), 1, row.size(), out);
+        }
+        std::fclose(out);
+        return true;
+    }
+
+  private:
+    enum Type { CLEAR, FILL, TEXTURE, MASK };
+
+    struct Command {
+        Type type;
+        Pixel color;
+        // The pixels covered, as [x0, x1) x [y0, y1), before clipping.
+        int x0, y0, x1, y1;
+        // The quad's exact left and top edges and size, for sampling.
+        double x, y, w, h;
+        const SoftTexture* texture;
+        const SoftMask* mask;
+    };
+
+    static Command MakeQuad(Type type, double x, double y, double w, double h, Pixel color) {
+        Command command = Command();
+        command.type = type;
+        command.color = color;
+        command.x = x;
+        command.y = y;
+        command.w = w;
+        command.h = h;
+        command.x0 = static_cast<int>(std::ceil(x - 0.5));
+        command.y0 = static_cast<int>(std::ceil(y - 0.5));
+        command.x1 = static_cast<int>(std::ceil(x + w - 0.5));
+        command.y1 = static_cast<int>(std::ceil(y + h - 0.5));
+        return command;
+    }
+
+    unsigned long long RasterizeBand(int top, int bottom) {
+        unsigned long long drawn = 0;
+        // Source colors of the textured and masked spans, before blending.
+        std::vector<Pixel> span(width_ + 4);
+        for (const Command& command : commands_) {
+            if (command.type == CLEAR) {
+                for (int y = top; y < bottom; ++y)
+                    FillSpan(Row(y), width_, command.color);
+                drawn += static_cast<unsigned long long>(bottom - top) * width_;
+                continue;
+            }
+            int x0 = std::max(0, command.x0), x1 = std::min(width_, command.x1);
+            int y0 = std::max(top, command.y0), y1 = std::min(bottom, command.y1);
+            if (x0 >= x1 || y0 >= y1)
+                continue;
+            int n = x1 - x0;
+            drawn += static_cast<unsigned long long>(y1 - y0) * n;
+            for (int y = y0; y < y1; ++y) {
+                Pixel* dst = Row(y) + x0;
+                if (command.type == FILL) {
+                    if ((command.color >> 24) == 0xFF)
+                        FillSpan(dst, n, command.color);
+                    else
+                        BlendColorSpan(dst, n, command.color);
+                    continue;
+                }
+                if (command.type == TEXTURE)
+                    SampleTexture(command, x0, n, y, span.data());
+                else
+                    SampleMask(command, x0, n, y, span.data());
+                BlendSpan(dst, span.data(), n);
+            }
+        }
+        return drawn;
+    }
+
+    Pixel* Row(int y) { return &pixels_[static_cast<std::size_t>(y) * width_]; }
+
+    // Nearest texel for each pixel center, modulated by the command's color.
+    void SampleTexture(const Command& command, int x0, int n, int y, Pixel* out) const {
+        const SoftTexture& texture = *command.texture;
+        int ty = std::min(texture.height - 1, std::max(0,
+            static_cast<int>((y + 0.5 - command.y) * texture.height / command.h)));
+        const Pixel* row = &texture.texels[static_cast<std::size_t>(ty) * texture.width];
+        // 16.16 fixed point texture coordinate.
+        int64_t step = static_cast<int64_t>(texture.width / command.w * 65536.0);
+        int64_t u = static_cast<int64_t>((x0 + 0.5 - command.x) * texture.width / command.w * 65536.0);
+        for (int i = 0; i < n; ++i, u += step)
+            out[i] = row[std::min<int64_t>(texture.width - 1, std::max<int64_t>(0, u >> 16))];
+        if (command.color != 0xFFFFFFFF)
+            ModulateSpan(out, n, command.color);
+    }
+
+    // The command's color with its alpha scaled by the coverage.
+    void SampleMask(const Command& command, int x0, int n, int y, Pixel* out) const {
+        const SoftMask& mask = *command.mask;
+        const uint8_t* coverage = &mask.coverage[static_cast<std::size_t>(y - command.y0) * mask.width + (x0 - command.x0)];
+        Pixel rgb = command.color & 0x00FFFFFF;
+        unsigned alpha = command.color >> 24;
+        for (int i = 0; i < n; ++i)
+            out[i] = rgb | ((coverage[i] * alpha + 127) / 255) << 24;
+    }
+
+    // Blend helpers compute a * b / 255 as (a * (b + (b >> 7))) >> 8, which is
+    // exact at 0 and 255 and within one elsewhere.
+    static unsigned Weight(unsigned alpha) { return alpha + (alpha >> 7); }
+
+#ifdef EXAMPLES_SOFTRASTERIZER_AVX2
+    // The AVX2 spans do as many whole groups of eight pixels as fit and return how
+    // many pixels that was, leaving the rest to the SSE2 and scalar loops. Unpacking
+    // and packing both work within 128-bit halves, so pixels keep their order.
+    __attribute__((target("avx2")))
+    static int FillSpanAVX2(Pixel* dst, int n, Pixel color) {
+        __m256i value = _mm256_set1_epi32(static_cast<int>(color));
+        int i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), value);
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static int BlendColorSpanAVX2(Pixel* dst, int n, Pixel color, unsigned weight) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i src = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(color)), zero);
+        __m256i src_weighted = _mm256_mullo_epi16(src, _mm256_set1_epi16(static_cast<short>(weight)));
+        __m256i dst_weight = _mm256_set1_epi16(static_cast<short>(256 - weight));
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(src_weighted, _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), dst_weight)), 8);
+            __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(src_weighted, _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), dst_weight)), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static int BlendSpanAVX2(Pixel* dst, const Pixel* src, int n) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i full = _mm256_set1_epi16(256);
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i s_lo = _mm256_unpacklo_epi8(s, zero), s_hi = _mm256_unpackhi_epi8(s, zero);
+            __m256i d_lo = _mm256_unpacklo_epi8(d, zero), d_hi = _mm256_unpackhi_epi8(d, zero);
+            __m256i a_lo = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_lo, 0xFF), 0xFF);
+            __m256i a_hi = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s_hi, 0xFF), 0xFF);
+            a_lo = _mm256_add_epi16(a_lo, _mm256_srli_epi16(a_lo, 7));
+            a_hi = _mm256_add_epi16(a_hi, _mm256_srli_epi16(a_hi, 7));
+            __m256i lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s_lo, a_lo),
+                                                            _mm256_mullo_epi16(d_lo, _mm256_sub_epi16(full, a_lo))), 8);
+            __m256i hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s_hi, a_hi),
+                                                            _mm256_mullo_epi16(d_hi, _mm256_sub_epi16(full, a_hi))), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static int ModulateSpanAVX2(Pixel* span, int n, Pixel color) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i c = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(color)), zero);
+        __m256i weight = _mm256_add_epi16(c, _mm256_srli_epi16(c, 7));
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(span + i));
+            __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), weight), 8);
+            __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), weight), 8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(span + i), _mm256_packus_epi16(lo, hi));
+        }
+        return i;
+    }
+#endif
+
+    void FillSpan(Pixel* dst, int n, Pixel color) const {
+        int i = 0;
+#ifdef EXAMPLES_SOFTRASTERIZER_AVX2
+        if (path_ == SpanPath::AVX2)
+            i = FillSpanAVX2(dst, n, color);
+#endif
+#ifdef EXAMPLES_SOFTRASTERIZER_SSE2
+        if (path_ != SpanPath::SCALAR) {
+            __m128i value = _mm_set1_epi32(static_cast<int>(color));
+            for (; i + 4 <= n; i += 4)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+        }
+#endif
+        for (; i < n; ++i)
+            dst[i] = color;
+    }
+
+    static Pixel BlendPixel(Pixel dst, Pixel src, unsigned weight) {
+        Pixel result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            unsigned s = (src >> shift) & 0xFF, d = (dst >> shift) & 0xFF;
+            result |= ((s * weight + d * (256 - weight)) >> 8) << shift;
+        }
+        return result;
+    }
+
+    // Blends a constant color over the span.
+    void BlendColorSpan(Pixel* dst, int n, Pixel color) const {
+        unsigned weight = Weight(color >> 24);
+        int i = 0;
+#ifdef EXAMPLES_SOFTRASTERIZER_AVX2
+        if (path_ == SpanPath::AVX2)
+            i = BlendColorSpanAVX2(dst, n, color, weight);
+#endif
+#ifdef EXAMPLES_SOFTRASTERIZER_SSE2
+        if (path_ != SpanPath::SCALAR) {
+            __m128i zero = _mm_setzero_si128();
+            __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+            __m128i src_weighted = _mm_mullo_epi16(src, _mm_set1_epi16(static_cast<short>(weight)));
+            __m128i dst_weight = _mm_set1_epi16(static_cast<short>(256 - weight));
+            for (; i + 4 <= n; i += 4) {
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i lo = _mm_srli_epi16(_mm_add_epi16(src_weighted, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), dst_weight)), 8);
+                __m128i hi = _mm_srli_epi16(_mm_add_epi16(src_weighted, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), dst_weight)), 8);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for (; i < n; ++i)
+            dst[i] = BlendPixel(dst[i], color, weight);
+    }
+
+    // Blends each source pixel over the span by its own alpha.
+    void BlendSpan(Pixel* dst, const Pixel* src, int n) const {
+        int i = 0;
+#ifdef EXAMPLES_SOFTRASTERIZER_AVX2
+        if (path_ == SpanPath::AVX2)
+            i = BlendSpanAVX2(dst, src, n);
+#endif
+#ifdef EXAMPLES_SOFTRASTERIZER_SSE2
+        if (path_ != SpanPath::SCALAR) {
+            __m128i zero = _mm_setzero_si128();
+            __m128i full = _mm_set1_epi16(256);
+            for (; i + 4 <= n; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+                __m128i s_lo = _mm_unpacklo_epi8(s, zero), s_hi = _mm_unpackhi_epi8(s, zero);
+                __m128i d_lo = _mm_unpacklo_epi8(d, zero), d_hi = _mm_unpackhi_epi8(d, zero);
+                // Broadcast each pixel's alpha to its four lanes and turn it into a weight.
+                __m128i a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xFF), 0xFF);
+                __m128i a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xFF), 0xFF);
+                a_lo = _mm_add_epi16(a_lo, _mm_srli_epi16(a_lo, 7));
+                a_hi = _mm_add_epi16(a_hi, _mm_srli_epi16(a_hi, 7));
+                __m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s_lo, a_lo),
+                                                          _mm_mullo_epi16(d_lo, _mm_sub_epi16(full, a_lo))), 8);
+                __m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s_hi, a_hi),
+                                                          _mm_mullo_epi16(d_hi, _mm_sub_epi16(full, a_hi))), 8);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for (; i < n; ++i)
+            dst[i] = BlendPixel(dst[i], src[i], Weight(src[i] >> 24));
+    }
+
+    // Multiplies each pixel of the span by color, channel by channel.
+    void ModulateSpan(Pixel* span, int n, Pixel color) const {
+        int i = 0;
+#ifdef EXAMPLES_SOFTRASTERIZER_AVX2
+        if (path_ == SpanPath::AVX2)
+            i = ModulateSpanAVX2(span, n, color);
+#endif
+#ifdef EXAMPLES_SOFTRASTERIZER_SSE2
+        if (path_ != SpanPath::SCALAR) {
+            __m128i zero = _mm_setzero_si128();
+            __m128i c = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), zero);
+            __m128i weight = _mm_add_epi16(c, _mm_srli_epi16(c, 7));
+            for (; i + 4 <= n; i += 4) {
+                __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(span + i));
+                __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), weight), 8);
+                __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), weight), 8);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(span + i), _mm_packus_epi16(lo, hi));
+            }
+        }
+#endif
+        for (; i < n; ++i) {
+            Pixel result = 0;
+            for (int shift = 0; shift < 32; shift += 8)
+                result |= ((((span[i] >> shift) & 0xFF) * Weight((color >> shift) & 0xFF)) >> 8) << shift;
+            span[i] = result;
+        }
+    }
+
+    int width_, height_;
+    std::vector<Pixel> pixels_;
+    std::vector<Command> commands_;
+    WorkStealingPool pool_;
+    unsigned num_threads_;
+    SpanPath path_;
+    unsigned long long pixels_drawn_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_SOFTRASTERIZER_H_
@@ -0,0 +1,193 @@
+#ifndef UGDK_EXAMPLES_SPATIALGRID_H_
+#define UGDK_EXAMPLES_SPATIALGRID_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace examples {
+
+// Axis-aligned bounds, as [min_x, max_x) x [min_y, max_y).
+struct Bounds {
+    Bounds() : min_x(0.0), min_y(0.0), max_x(0.0), max_y(0.0) {}
+    Bounds(double min_x, double min_y, double max_x, double max_y)
+        : min_x(min_x), min_y(min_y), max_x(max_x), max_y(max_y) {}
+
+    // Bounds of a w by h object centered on (x, y), like a node with a CENTER hotspot.
+    static Bounds Centered(double x, double y, double w, double h) {
+        return Bounds(x - w * 0.5, y - h * 0.5, x + w * 0.5, y + h * 0.5);
+    }
+
+    bool Contains(double x, double y) const {
+        return x >= min_x && x < max_x && y >= min_y && y < max_y;
+    }
+
+    bool Intersects(const Bounds& other) const {
+        return min_x < other.max_x && other.min_x < max_x && min_y < other.max_y && other.min_y < max_y;
+    }
+
+    double min_x, min_y, max_x, max_y;
+};
+
+// Uniform grid over the bounds of many objects, like the nodes of a scene, for
+// point and rectangle queries. Each object is listed in every cell its bounds
+// overlap, so a query only looks at the objects of the cells it touches.
+//
+// Objects are identified by the ids given to Insert, which should be small and
+// dense since they index a vector. Each one also has a draw order: Pick returns,
+// among the objects under a point, the one with the highest order, which is the
+// one drawn last and so on top.
+//
+// Moving an object only touches the grid when it crosses into other cells.
+// Bounds outside the area given to the constructor are clamped to the border cells.
+class SpatialGrid {
+  public:
+    typedef std::size_t Id;
+    static const Id NONE = static_cast<Id>(-1);
+
+    SpatialGrid(const Bounds& area, double cell_size)
+        : area_(area)
+        , cell_size_(cell_size)
+        , columns_(std::max(1, static_cast<int>((area.max_x - area.min_x) / cell_size) + 1))
+        , rows_(std::max(1, static_cast<int>((area.max_y - area.min_y) / cell_size) + 1))
+        , cells_(static_cast<std::size_t>(columns_) * rows_)
+        , stamp_(0)
+        , size_(0)
+    {}
+
+    std::size_t size() const { return size_; }
+    bool contains(Id id) const { return id < entries_.size() && entries_[id].alive; }
+    const Bounds& bounds(Id id) const { return entries_[id].bounds; }
+    unsigned order(Id id) const { return entries_[id].order; }
+
+    void Insert(Id id, const Bounds& bounds, unsigned order) {
+        if (id >= entries_.size())
+            entries_.resize(id + 1);
+        Entry& entry = entries_[id];
+        entry.bounds = bounds;
+        entry.order = order;
+        entry.alive = true;
+        entry.stamp = 0;
+        entry.range = CellRange(bounds);
+        AddToCells(id, entry.range);
+        ++size_;
+    }
+
+    void Remove(Id id) {
+        Entry& entry = entries_[id];
+        RemoveFromCells(id, entry.range);
+        entry.alive = false;
+        --size_;
+    }
+
+    void Move(Id id, const Bounds& bounds) {
+        Entry& entry = entries_[id];
+        entry.bounds = bounds;
+        Range range = CellRange(bounds);
+        if (range == entry.range)
+            return;
+        RemoveFromCells(id, entry.range);
+        AddToCells(id, range);
+        entry.range = range;
+    }
+
+    void set_order(Id id, unsigned order) { entries_[id].order = order; }
+
+    // Appends the ids of every object containing (x, y), in no particular order.
+    void QueryPoint(double x, double y, std::vector<Id>& result) const {
+        for (Id id : cells_[CellIndex(Column(x), Row(y))])
+            if (entries_[id].bounds.Contains(x, y))
+                result.push_back(id);
+    }
+
+    // Appends the ids of every object intersecting rect, each once, in no particular order.
+    void QueryRect(const Bounds& rect, std::vector<Id>& result) {
+        Range range = CellRange(rect);
+        ++stamp_;
+        for (int row = range.min_row; row <= range.max_row; ++row)
+            for (int column = range.min_column; column <= range.max_column; ++column)
+                for (Id id : cells_[CellIndex(column, row)]) {
+                    Entry& entry = entries_[id];
+                    if (entry.stamp != stamp_ && entry.bounds.Intersects(rect)) {
+                        entry.stamp = stamp_;
+                        result.push_back(id);
+                    }
+                }
+    }
+
+    // The top-most object containing (x, y), or NONE.
+    Id Pick(double x, double y) const {
+        Id best = NONE;
+        for (Id id : cells_[CellIndex(Column(x), Row(y))]) {
+            const Entry& entry = entries_[id];
+            if (entry.bounds.Contains(x, y) && (best == NONE || entry.order > entries_[best].order))
+                best = id;
+        }
+        return best;
+    }
+
+  private:
+    struct Range {
+        int min_column, min_row, max_column, max_row;
+
+        bool operator==(const Range& other) const {
+            return min_column == other.min_column && min_row == other.min_row
+                && max_column == other.max_column && max_row == other.max_row;
+        }
+    };
+
+    struct Entry {
+        Entry() : order(0), alive(false), stamp(0) {}
+
+        Bounds bounds;
+        Range range;
+        unsigned order;
+        bool alive;
+        unsigned stamp;
+    };
+
+    int Column(double x) const {
+        return std::min(columns_ - 1, std::max(0, static_cast<int>((x - area_.min_x) / cell_size_)));
+    }
+
+    int Row(double y) const {
+        return std::min(rows_ - 1, std::max(0, static_cast<int>((y - area_.min_y) / cell_size_)));
+    }
+
+    std::size_t CellIndex(int column, int row) const {
+        return static_cast<std::size_t>(row) * columns_ + column;
+    }
+
+    Range CellRange(const Bounds& bounds) const {
+        Range range = { Column(bounds.min_x), Row(bounds.min_y), Column(bounds.max_x), Row(bounds.max_y) };
+        return range;
+    }
+
+    void AddToCells(Id id, const Range& range) {
+        for (int row = range.min_row; row <= range.max_row; ++row)
+            for (int column = range.min_column; column <= range.max_column; ++column)
+                cells_[CellIndex(column, row)].push_back(id);
+    }
+
+    void RemoveFromCells(Id id, const Range& range) {
+        for (int row = range.min_row; row <= range.max_row; ++row)
+            for (int column = range.min_column; column <= range.max_column; ++column) {
+                std::vector<Id>& cell = cells_[CellIndex(column, row)];
+                auto it = std::find(cell.begin(), cell.end(), id);
+                *it = cell.back();
+                cell.pop_back();
+            }
+    }
+
+    Bounds area_;
+    double cell_size_;
+    int columns_, rows_;
+    std::vector<std::vector<Id>> cells_;
+    std::vector<Entry> entries_;
+    unsigned stamp_;
+    std::size_t size_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_SPATIALGRID_H_
@@ -0,0 +1,188 @@
+#ifndef UGDK_EXAMPLES_STREAMINGTEXTBOX_H_
+#define UGDK_EXAMPLES_STREAMINGTEXTBOX_H_
+
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/geometry.h>
+#include <ugdk/text/font.h>
+#include <ugdk/text/label.h>
+#include <ugdk/ui/drawable.h>
+
+#include <examples/mappedfile.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace examples {
+
+// Text box for files too big to load: the file is memory mapped, line offsets are
+// found only as far as the reader scrolls, and only the lines inside the box get a
+// text::Label. Startup time and memory don't depend on the file size.
+//
+// Offsets are indexed sparsely, one every LINES_PER_CHECKPOINT lines, and the lines
+// in between are found by scanning from the closest checkpoint. Lines longer than
+// max_columns bytes are cut.
+class StreamingTextBox : public ugdk::ui::Drawable {
+  public:
+    static const std::size_t LINES_PER_CHECKPOINT = 64;
+
+    StreamingTextBox(const std::string& path, ugdk::text::Font* font, const ugdk::math::Vector2D& size)
+        : font_(font)
+        , size_(size)
+        , max_columns_(256)
+        , first_line_(0)
+        , indexed_lines_(0)
+        , index_complete_(false)
+    {
+        if (file_.Open(path))
+            indexed_lines_ = 1;
+        checkpoints_.push_back(0);
+        ugdk::text::Label probe("Ag", font_);
+        line_height_ = std::max(1.0, probe.height());
+        visible_lines_ = static_cast<std::size_t>(size_.y / line_height_);
+        IndexUpTo(visible_lines_);
+    }
+
+    bool is_open() const { return file_.is_open(); }
+    std::size_t file_size() const { return file_.size(); }
+
+    void set_max_columns(std::size_t max_columns) {
+        max_columns_ = max_columns;
+        labels_.clear();
+    }
+
+    void Draw(ugdk::graphic::Canvas& canvas) const override {
+        UpdateVisibleLabels();
+        canvas.PushAndCompose(ugdk::graphic::Geometry(hotspot() * -1.0));
+        for (std::size_t i = 0; i < labels_.size(); ++i) {
+            if (!labels_[i])
+                continue;
+            canvas.PushAndCompose(ugdk::graphic::Geometry(ugdk::math::Vector2D(0.0, i * line_height_)));
+            labels_[i]->Draw(canvas);
+            canvas.PopGeometry();
+        }
+        canvas.PopGeometry();
+    }
+
+    const ugdk::math::Vector2D& size() const override { return size_; }
+
+    // Scrolls by delta lines, stopping at the first and last lines.
+    void Scroll(long delta) {
+        if (delta < 0)
+            ScrollTo(first_line_ > static_cast<std::size_t>(-delta) ? first_line_ + delta : 0);
+        else
+            ScrollTo(first_line_ + static_cast<std::size_t>(delta));
+    }
+
+    void ScrollTo(std::size_t line) {
+        line = std::min(line, static_cast<std::size_t>(-1) - visible_lines_);
+        IndexUpTo(line + visible_lines_);
+        if (index_complete_)
+            line = std::min(line, indexed_lines_ > visible_lines_ ? indexed_lines_ - visible_lines_ : 0);
+        first_line_ = line;
+    }
+
+    // Scrolls to the end, which indexes the whole file.
+    void ScrollToEnd() {
+        IndexUpTo(static_cast<std::size_t>(-1));
+        ScrollTo(indexed_lines_);
+    }
+
+    std::size_t first_line() const { return first_line_; }
+    std::size_t visible_lines() const { return visible_lines_; }
+    double line_height() const { return line_height_; }
+
+    // Lines found so far; the total once index_complete() is true.
+    std::size_t indexed_lines() const { return indexed_lines_; }
+    bool index_complete() const { return index_complete_; }
+
+    // Memory taken by the line index, in bytes.
+    std::size_t index_memory() const { return checkpoints_.capacity() * sizeof(std::size_t); }
+
+  private:
+    // Finds where lines start until `line` is known or the file ends, resuming from
+    // the last checkpoint.
+    void IndexUpTo(std::size_t line) {
+        if (!file_.is_open())
+            return;
+        std::size_t offset = checkpoints_.back();
+        std::size_t current = (checkpoints_.size() - 1) * LINES_PER_CHECKPOINT;
+        while (!index_complete_ && indexed_lines_ <= line) {
+            offset = NextLine(offset);
+            ++current;
+            if (offset >= file_.size()) {
+                index_complete_ = true;
+                indexed_lines_ = current;
+            } else {
+                // Line `current` starts at offset.
+                indexed_lines_ = std::max(indexed_lines_, current + 1);
+                if (current % LINES_PER_CHECKPOINT == 0 && current / LINES_PER_CHECKPOINT == checkpoints_.size())
+                    checkpoints_.push_back(offset);
+            }
+        }
+    }
+
+    // Byte range of a line that's already indexed.
+    void LineRange(std::size_t line, std::size_t& begin, std::size_t& end) const {
+        begin = checkpoints_[line / LINES_PER_CHECKPOINT];
+        for (std::size_t i = line % LINES_PER_CHECKPOINT; i > 0; --i)
+            begin = NextLine(begin);
+        end = NextLine(begin);
+        while (end > begin && (file_.data()[end - 1] == '\n' || file_.data()[end - 1] == '\r'))
+            --end;
+    }
+
+    std::size_t NextLine(std::size_t offset) const {
+        const char* newline = static_cast<const char*>(std::memchr(file_.data() + offset, '\n', file_.size() - offset));
+        return newline ? static_cast<std::size_t>(newline - file_.data()) + 1 : file_.size();
+    }
+
+    // Keeps one label per visible line, creating labels only for lines that just
+    // scrolled into view.
+    void UpdateVisibleLabels() const {
+        if (labels_.size() == visible_lines_ && labels_first_line_ == first_line_)
+            return;
+
+        std::vector<std::unique_ptr<ugdk::text::Label>> labels(visible_lines_);
+        for (std::size_t i = 0; i < visible_lines_; ++i) {
+            std::size_t line = first_line_ + i;
+            if (line >= indexed_lines_)
+                break;
+            if (line >= labels_first_line_ && line - labels_first_line_ < labels_.size()) {
+                labels[i] = std::move(labels_[line - labels_first_line_]);
+                continue;
+            }
+            std::size_t begin, end;
+            LineRange(line, begin, end);
+            std::size_t length = std::min(end - begin, max_columns_);
+            // Don't cut a UTF-8 sequence in half.
+            while (length > 0 && length < end - begin && (file_.data()[begin + length] & 0xC0) == 0x80)
+                --length;
+            if (length > 0)
+                labels[i].reset(new ugdk::text::Label(std::string(file_.data() + begin, length), font_));
+        }
+        labels_.swap(labels);
+        labels_first_line_ = first_line_;
+    }
+
+    MappedFile file_;
+    ugdk::text::Font* font_;
+    ugdk::math::Vector2D size_;
+    double line_height_;
+    std::size_t max_columns_;
+    std::size_t visible_lines_;
+    std::size_t first_line_;
+    std::size_t indexed_lines_;
+    bool index_complete_;
+    std::vector<std::size_t> checkpoints_;
+    // Labels are created while drawing, for the lines that are visible then.
+    mutable std::vector<std::unique_ptr<ugdk::text::Label>> labels_;
+    mutable std::size_t labels_first_line_ = 0;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_STREAMINGTEXTBOX_H_
@@ -0,0 +1,161 @@
+#ifndef UGDK_EXAMPLES_WORKSTEALINGPOOL_H_
+#define UGDK_EXAMPLES_WORKSTEALINGPOOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace examples {
+
+// Thread pool where each worker has its own queue. Workers run their newest task
+// first and, when out of work, steal the oldest task of another queue, so tasks
+// submitted by a task usually run on the same core.
+//
+// Threads that aren't workers submit to a shared queue and may help by calling
+// RunOne. With zero workers every task runs inside RunOne.
+class WorkStealingPool {
+  public:
+    typedef std::function<void ()> Task;
+
+    explicit WorkStealingPool(unsigned num_workers)
+        : queued_(0)
+        , started_(false)
+        , stopping_(false)
+    {
+        // The last queue is shared by the threads that aren't workers.
+        for (unsigned i = 0; i <= num_workers; ++i)
+            queues_.emplace_back(new Queue);
+        for (unsigned i = 0; i < num_workers; ++i)
+            workers_.emplace_back([this, i] { WorkerLoop(i); });
+        {
+            // Workers wait for this, so they only read workers_ once it's complete.
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            started_ = true;
+        }
+        wake_.notify_all();
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned num_workers() const { return static_cast<unsigned>(workers_.size()); }
+
+    // May be called from any thread, including from inside a task.
+    void Submit(Task task) {
+        Queue& queue = *queues_[CurrentQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+        {
+            // Taking the lock makes sure a worker about to sleep sees the new task.
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+    }
+
+    // Runs one queued task on the calling thread. Returns false if there was none.
+    bool RunOne() {
+        Task task;
+        if (!Take(CurrentQueue(), task))
+            return false;
+        task();
+        return true;
+    }
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Index of the calling worker's queue, or of the shared queue.
+    std::size_t CurrentQueue() const {
+        std::thread::id id = std::this_thread::get_id();
+        for (std::size_t i = 0; i < workers_.size(); ++i)
+            if (workers_[i].get_id() == id)
+                return i;
+        return workers_.size();
+    }
+
+    // Takes the newest task of queue `own`, or else steals the oldest of another.
+    bool Take(std::size_t own, Task& task) {
+        if (queued_.load(std::memory_order_acquire) == 0)
+            return false;
+        {
+            Queue& queue = *queues_[own];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            Queue& victim = *queues_[(own + i) % queues_.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void WorkerLoop(std::size_t index) {
+        {
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return started_; });
+        }
+        Task task;
+        for (;;) {
+            // Spin a little before sleeping, since frames submit work in bursts.
+            bool found = false;
+            for (int spin = 0; spin < 64 && !found; ++spin) {
+                found = Take(index, task);
+                if (!found)
+                    std::this_thread::yield();
+            }
+            if (found) {
+                task();
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stopping_)
+                return;
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::atomic<std::size_t> queued_;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool started_, stopping_;
+    std::vector<std::thread> workers_;
+};
+
+} // namespace examples
+
+#endif // UGDK_EXAMPLES_WORKSTEALINGPOOL_H_
@@ -1,4 +1,13 @@
+// A box that follows the mouse.
+//
+// Options, besides those of examples::ParseLatencyOptions:
+//   --motion-work=US  busy-wait this long in every motion handler, standing in for
+//                     the hit tests and relayouts of a real tool
+// Input latency percentiles are printed once per second. With --coalesce-motion
+// the handler runs once per frame with the newest motion instead of once per event.
+
 #include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
 #include <ugdk/action/scene.h>
 #include <ugdk/input/events.h>
 #include <ugdk/desktop/window.h>
@@ -7,34 +16,84 @@
 #include <ugdk/system/compatibility.h>
 #include <ugdk/ui/drawable/texturedrectangle.h>
 
+#include <examples/benchmark.h>
+#include <examples/inputlatency.h>
+#include <examples/inputrecord.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
 
 using namespace ugdk;
 
 namespace {
     const static math::Vector2D box_size(50.0, 50.0);
+
+    void BusyWait(std::chrono::microseconds duration) {
+        auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end) {}
+    }
 }
 
 int main(int argc, char *argv[]) {
-    system::Initialize();
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+    examples::InputRecordingOptions input_options = examples::ParseInputRecordingOptions(argc, argv);
+    examples::InputRecorder recorder(input_options.record_path);
+    examples::InputReplay replay(input_options.replay_path);
+    examples::LatencyOptions latency_options = examples::ParseLatencyOptions(argc, argv);
+    examples::InputLatency latency(latency_options);
+    std::chrono::microseconds motion_work(0);
+    for (int i = 1; i < argc; ++i)
+        if (std::strncmp(argv[i], "--motion-work=", 14) == 0)
+            motion_work = std::chrono::microseconds(std::atoi(argv[i] + 14));
+
+    system::Configuration config;
+    bench.Configure(config);
+    system::Initialize(config);
 
     auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    latency.Attach(*scene);
+    recorder.Attach(*scene);
+    replay.Attach(*scene);
     math::Vector2D box_position;
     {
         auto rect = std::make_shared<ui::TexturedRectangle>(graphic::manager()->white_texture(), box_size);
         rect->set_hotspot(ui::HookPoint::CENTER);
 
-        scene->event_handler().AddListener<input::MouseMotionEvent>([rect, &box_position](const input::MouseMotionEvent& ev) {
+        auto move_box = [&box_position, &latency, motion_work](const input::MouseMotionEvent& ev,
+                                                               std::chrono::steady_clock::time_point stamp) {
+            BusyWait(motion_work);
             auto window = ev.window.lock();
             box_position.x = double(ev.position.x) / window->size().x;
             box_position.y = double(ev.position.y) / window->size().y;
-        });
-        scene->set_render_function([rect, &box_position](graphic::Canvas& canvas) {
+            latency.Applied(stamp);
+        };
+        if (latency_options.coalesce_motion) {
+            auto coalescer = std::make_shared<examples::MotionCoalescer>(move_box);
+            scene->event_handler().AddListener<input::MouseMotionEvent>([coalescer](const input::MouseMotionEvent& ev) {
+                coalescer->Push(ev, std::chrono::steady_clock::now());
+            });
+            auto frames = std::make_shared<unsigned>(0);
+            scene->AddTask(bench.Task([coalescer, frames](double) {
+                coalescer->Deliver();
+                if (++*frames % 120 == 0)
+                    printf("motion: %llu events received, %llu delivered\n",
+                           coalescer->received(), coalescer->delivered());
+            }, "coalesced motion"));
+        } else {
+            scene->event_handler().AddListener<input::MouseMotionEvent>([move_box](const input::MouseMotionEvent& ev) {
+                move_box(ev, std::chrono::steady_clock::now());
+            });
+        }
+        scene->set_render_function(bench.Render(latency.Render([rect, &box_position](graphic::Canvas& canvas) {
             math::Vector2D canvas_position = box_position.Scale(canvas.size());
             canvas.PushAndCompose(graphic::Geometry(canvas_position));
             rect->Draw(canvas);
             canvas.PopGeometry();
-        });
+        })));
 
     }
     system::PushScene(std::move(scene));
@@ -0,0 +1,151 @@
+// Compares delivering joystick axis events one at a time, to a
+// system::Listener<input::JoystickAxisEvent>, against examples::EventBatcher
+// handing them to an examples::BatchListener once per frame, with and without
+// per-axis coalescing. Modelled on joystick-box: every listener has its own
+// joystick event handler, the events cycle through every axis of the joystick,
+// and the listener moves one node from axes 0 and 1.
+//
+// Options:
+//   --events=N  axis events per listener per frame (default 10)
+//   --axes=N    axes the events are spread over (default 6)
+//   --frames=N  frames per measurement (default 100)
+
+#include <ugdk/input/events.h>
+#include <ugdk/system/eventhandler.h>
+
+#include <examples/eventbatcher.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace {
+    using ugdk::input::JoystickAxisEvent;
+
+    // Same shape as ui::Node's geometry: setting the offset rebuilds the matrix.
+    struct Geometry {
+        Geometry() : x(0.0), y(0.0) { std::memset(matrix, 0, sizeof(matrix)); }
+        void set_offset(double ox, double oy) {
+            x = ox;
+            y = oy;
+            matrix[0] = 1.0; matrix[4] = 1.0;
+            matrix[2] = x;   matrix[5] = y;
+        }
+        double x, y;
+        double matrix[6];
+    };
+
+    // MovableRect::Handle without batching: one geometry write per event.
+    class PerEventRect : public ugdk::system::Listener<JoystickAxisEvent> {
+      public:
+        void Handle(const JoystickAxisEvent& ev) override {
+            double x = geometry.x, y = geometry.y;
+            if (ev.axis_id == 0)
+                x = 100 * ev.axis_status.Percentage();
+            else if (ev.axis_id == 1)
+                y = 100 * ev.axis_status.Percentage();
+            geometry.set_offset(x, y);
+        }
+        Geometry geometry;
+    };
+
+    // MovableRect::HandleBatch: one geometry write per frame.
+    class BatchedRect : public examples::BatchListener<JoystickAxisEvent> {
+      public:
+        void HandleBatch(const JoystickAxisEvent* begin, const JoystickAxisEvent* end) override {
+            double x = geometry.x, y = geometry.y;
+            for (const JoystickAxisEvent* ev = begin; ev != end; ++ev) {
+                if (ev->axis_id == 0)
+                    x = 100 * ev->axis_status.Percentage();
+                else if (ev->axis_id == 1)
+                    y = 100 * ev->axis_status.Percentage();
+            }
+            geometry.set_offset(x, y);
+        }
+        examples::EventBatcher<JoystickAxisEvent> batcher;
+        Geometry geometry;
+    };
+
+    std::size_t AxisKey(const JoystickAxisEvent& ev) {
+        return static_cast<std::size_t>(ev.axis_id);
+    }
+
+    enum class Mode { PER_EVENT, BATCHED, COALESCED };
+
+    // Returns the time spent delivering events, in nanoseconds per event.
+    double Measure(Mode mode, int num_listeners, int events_per_frame, int num_axes, int frames) {
+        std::vector<std::unique_ptr<ugdk::system::EventHandler>> handlers;
+        std::vector<std::unique_ptr<PerEventRect>> per_event;
+        std::vector<std::unique_ptr<BatchedRect>> batched;
+        for (int i = 0; i < num_listeners; ++i) {
+            handlers.emplace_back(new ugdk::system::EventHandler);
+            if (mode == Mode::PER_EVENT) {
+                per_event.emplace_back(new PerEventRect);
+                handlers.back()->AddObjectListener(per_event.back().get());
+            } else {
+                batched.emplace_back(new BatchedRect);
+                BatchedRect* rect = batched.back().get();
+                // Every axis of the joystick has a key, not only the ones the rect uses.
+                if (mode == Mode::COALESCED)
+                    rect->batcher.EnableCoalescing(&AxisKey, num_axes);
+                rect->batcher.AddBatchListener(rect);
+                handlers.back()->AddObjectListener(&rect->batcher);
+            }
+        }
+
+        std::weak_ptr<ugdk::input::Joystick> no_joystick;
+        auto begin = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            for (int e = 0; e < events_per_frame; ++e) {
+                int raw = ((frame + e) % 200 - 100) * 327;
+                JoystickAxisEvent ev(no_joystick, e % num_axes, ugdk::input::AxisStatus(raw));
+                for (const auto& handler : handlers)
+                    handler->RaiseEvent(ev);
+            }
+            for (const auto& rect : batched)
+                rect->batcher.Flush();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        // Keeps the geometry writes from being optimized away.
+        double checksum = 0.0;
+        for (const auto& rect : per_event) checksum += rect->geometry.matrix[2];
+        for (const auto& rect : batched) checksum += rect->geometry.matrix[2];
+        if (checksum == 12345.0)
+            std::printf(" ");
+
+        double total_events = double(num_listeners) * events_per_frame * frames;
+        return std::chrono::duration<double, std::nano>(end - begin).count() / total_events;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int events_per_frame = 10;
+    int num_axes = 6;
+    int frames = 100;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--events=", 9) == 0)
+            events_per_frame = std::atoi(argv[i] + 9);
+        else if (std::strncmp(argv[i], "--axes=", 7) == 0)
+            num_axes = std::max(1, std::atoi(argv[i] + 7));
+        else if (std::strncmp(argv[i], "--frames=", 9) == 0)
+            frames = std::atoi(argv[i] + 9);
+    }
+
+    std::printf("%d axis events over %d axes per listener per frame, %d frames\n", events_per_frame, num_axes, frames);
+    std::printf("listeners,per_event_ns,batched_ns,coalesced_ns,per_event_ms_per_frame,coalesced_ms_per_frame\n");
+    const int listener_counts[] = { 100, 1000, 5000, 10000 };
+    for (int num_listeners : listener_counts) {
+        double per_event = Measure(Mode::PER_EVENT, num_listeners, events_per_frame, num_axes, frames);
+        double batched = Measure(Mode::BATCHED, num_listeners, events_per_frame, num_axes, frames);
+        double coalesced = Measure(Mode::COALESCED, num_listeners, events_per_frame, num_axes, frames);
+        double events = double(num_listeners) * events_per_frame;
+        std::printf("%d,%.1f,%.1f,%.1f,%.3f,%.3f\n", num_listeners, per_event, batched, coalesced,
+                    per_event * events * 1e-6, coalesced * events * 1e-6);
+    }
+    return 0;
+}
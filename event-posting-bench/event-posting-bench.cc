@@ -0,0 +1,191 @@
+// Measures examples::PostedEvents with 1 to 16 producer threads posting events
+// while the main thread drains them once per frame into a system::EventHandler,
+// whose listener sees every event, and the bare examples::MPSCQueue behind it for
+// comparison. The drain column is the main thread's time per event: popping it, plus
+// the handler's dispatch for PostedEvents.
+//
+// Options:
+//   --events=N       events posted by each producer (default 200000)
+//   --frame-us=N     time between two drains, in microseconds (default 1000)
+//   --capacity=N     queue capacity (default 65536)
+//   --max-threads=N  largest number of producers (default 16)
+
+#include <ugdk/system/eventhandler.h>
+
+#include <examples/mpscqueue.h>
+#include <examples/postedevents.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // Same size and shape as a joystick axis event, plus the time it was posted.
+    struct AxisEvent {
+        AxisEvent(int64_t time, int producer, int axis, double value)
+            : post_time(time), producer(producer), axis(axis), value(value) {}
+        int64_t post_time;
+        int producer;
+        int axis;
+        double value;
+    };
+
+    int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    struct Result {
+        double posting_rate;
+        double p50_us, p99_us, max_us;
+        double drain_ns;
+        unsigned long long full_retries;
+        unsigned frames;
+    };
+
+    void RecordLatency(std::vector<uint32_t>& latencies, int64_t drain_time, const AxisEvent& ev) {
+        latencies.push_back(static_cast<uint32_t>((drain_time - ev.post_time) / 1000));
+    }
+
+    // The bare queue: events are popped straight into the latencies.
+    class QueueTarget {
+      public:
+        explicit QueueTarget(std::size_t capacity) : queue_(capacity) {}
+
+        bool Post(const AxisEvent& ev) { return queue_.TryPush(ev); }
+
+        void Drain(std::vector<uint32_t>& latencies, int64_t drain_time) {
+            queue_.Drain([&latencies, drain_time](const AxisEvent& ev) {
+                RecordLatency(latencies, drain_time, ev);
+            }, latencies.capacity());
+        }
+
+      private:
+        examples::MPSCQueue<AxisEvent> queue_;
+    };
+
+    // What an example does: events are raised on an EventHandler, and the
+    // latencies are recorded by one of its listeners.
+    class PostedTarget {
+      public:
+        explicit PostedTarget(std::size_t capacity)
+            : posted_(capacity)
+            , latencies_(nullptr)
+            , drain_time_(0)
+        {
+            handler_.AddListener(std::function<void (const AxisEvent&)>([this](const AxisEvent& ev) {
+                RecordLatency(*latencies_, drain_time_, ev);
+            }));
+        }
+
+        bool Post(const AxisEvent& ev) { return posted_.Post(ev); }
+
+        void Drain(std::vector<uint32_t>& latencies, int64_t drain_time) {
+            latencies_ = &latencies;
+            drain_time_ = drain_time;
+            posted_.Drain(handler_);
+        }
+
+      private:
+        examples::PostedEvents<AxisEvent> posted_;
+        ugdk::system::EventHandler handler_;
+        std::vector<uint32_t>* latencies_;
+        int64_t drain_time_;
+    };
+
+    template<typename Target>
+    Result Run(int num_threads, std::size_t events_per_thread, std::size_t capacity, std::chrono::microseconds frame) {
+        Target queue(capacity);
+        std::atomic<bool> start(false);
+        std::atomic<unsigned long long> full_retries(0);
+        std::atomic<int64_t> last_post(0);
+
+        std::vector<std::thread> producers;
+        for (int t = 0; t < num_threads; ++t) {
+            producers.emplace_back([&, t] {
+                while (!start.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                unsigned long long retries = 0;
+                for (std::size_t i = 0; i < events_per_thread; ++i) {
+                    AxisEvent ev(Now(), t, static_cast<int>(i % 6), (i % 200) / 100.0 - 1.0);
+                    while (!queue.Post(ev)) {
+                        ++retries;
+                        std::this_thread::yield();
+                    }
+                }
+                full_retries.fetch_add(retries);
+                int64_t end = Now();
+                int64_t previous = last_post.load();
+                while (previous < end && !last_post.compare_exchange_weak(previous, end)) {}
+            });
+        }
+
+        const std::size_t total = events_per_thread * num_threads;
+        std::vector<uint32_t> latencies;
+        latencies.reserve(total);
+
+        int64_t begin = Now();
+        start.store(true, std::memory_order_release);
+
+        Result result = Result();
+        int64_t drain_total = 0;
+        Clock::time_point next_frame = Clock::now() + frame;
+        while (latencies.size() < total) {
+            std::this_thread::sleep_until(next_frame);
+            next_frame += frame;
+            int64_t drain_time = Now();
+            queue.Drain(latencies, drain_time);
+            drain_total += Now() - drain_time;
+            ++result.frames;
+        }
+        for (auto& producer : producers)
+            producer.join();
+
+        std::sort(latencies.begin(), latencies.end());
+        result.posting_rate = total / ((last_post.load() - begin) * 1e-9);
+        result.p50_us = latencies[latencies.size() / 2];
+        result.p99_us = latencies[latencies.size() * 99 / 100];
+        result.max_us = latencies.back();
+        result.drain_ns = double(drain_total) / total;
+        result.full_retries = full_retries.load();
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t events = 200000;
+    std::size_t capacity = 65536;
+    int frame_us = 1000;
+    int max_threads = 16;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--events=", 9) == 0)
+            events = std::strtoul(argv[i] + 9, nullptr, 10);
+        else if (std::strncmp(argv[i], "--frame-us=", 11) == 0)
+            frame_us = std::atoi(argv[i] + 11);
+        else if (std::strncmp(argv[i], "--capacity=", 11) == 0)
+            capacity = std::strtoul(argv[i] + 11, nullptr, 10);
+        else if (std::strncmp(argv[i], "--max-threads=", 14) == 0)
+            max_threads = std::atoi(argv[i] + 14);
+    }
+
+    printf("%d events per producer, queue capacity %u, drain every %d us\n",
+           static_cast<int>(events), static_cast<unsigned>(capacity), frame_us);
+    printf("mode,threads,post_mevents_per_s,drain_p50_us,drain_p99_us,drain_max_us,drain_ns_per_event,full_retries,frames\n");
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        Result r = Run<QueueTarget>(threads, events, capacity, std::chrono::microseconds(frame_us));
+        printf("queue,%d,%.2f,%.0f,%.0f,%.0f,%.1f,%llu,%u\n", threads, r.posting_rate / 1e6,
+               r.p50_us, r.p99_us, r.max_us, r.drain_ns, r.full_retries, r.frames);
+        r = Run<PostedTarget>(threads, events, capacity, std::chrono::microseconds(frame_us));
+        printf("posted,%d,%.2f,%.0f,%.0f,%.0f,%.1f,%llu,%u\n", threads, r.posting_rate / 1e6,
+               r.p50_us, r.p99_us, r.max_us, r.drain_ns, r.full_retries, r.frames);
+    }
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Compares loading a font's glyphs cold, by parsing the font and rasterizing every
+// glyph with FreeType, against loading them warm from examples::GlyphCache.
+//
+// The charset is printable ASCII plus every character of a text file, by default
+// the touhou text of text-from-files, whose CJK characters make it the slowest.
+//
+// Usage: example-glyph-cache-bench [options] [font path]
+//   --size=N          pixel size (default 30)
+//   --text=PATH       text whose characters are loaded
+//   --cache-dir=DIR   where cache files go (default: the current directory)
+//   --runs=N          warm loads measured (default 20)
+
+#include <examples/glyphcache.h>
+#include <examples/mappedfile.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    // Keeps the compiler from dropping work whose result is otherwise unused.
+    volatile unsigned long long sink;
+
+    double MillisecondsSince(Clock::time_point begin) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    }
+
+    bool SameAtlas(const examples::GlyphAtlas& a, const examples::GlyphAtlas& b) {
+        return a.width() == b.width() && a.height() == b.height() && a.num_glyphs() == b.num_glyphs()
+            && std::memcmp(a.glyphs(), b.glyphs(), a.num_glyphs() * sizeof(examples::GlyphMetrics)) == 0
+            && std::memcmp(a.pixels(), b.pixels(), static_cast<std::size_t>(a.width()) * a.height()) == 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string font_path = EXAMPLE_LOCATION "/../joystick-display/content/DejaVuSansMono.ttf";
+    std::string text_path = EXAMPLE_LOCATION "/../text-from-files/content/touhou.txt";
+    std::string cache_dir = ".";
+    int size = 30, runs = 20;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--size=", 7) == 0)
+            size = std::max(1, std::atoi(argv[i] + 7));
+        else if (std::strncmp(argv[i], "--text=", 7) == 0)
+            text_path = argv[i] + 7;
+        else if (std::strncmp(argv[i], "--cache-dir=", 12) == 0)
+            cache_dir = argv[i] + 12;
+        else if (std::strncmp(argv[i], "--runs=", 7) == 0)
+            runs = std::max(1, std::atoi(argv[i] + 7));
+        else
+            font_path = argv[i];
+    }
+
+    std::string charset;
+    for (char c = ' '; c <= '~'; ++c)
+        charset += c;
+    examples::MappedFile text(text_path);
+    if (text.is_open())
+        charset.append(text.data(), text.size());
+    else
+        std::fprintf(stderr, "Unable to open '%s', loading only ASCII.\n", text_path.c_str());
+    std::vector<uint32_t> codepoints = examples::CodepointsOf(charset.data(), charset.size());
+
+    // Cold: what every run costs without the cache.
+    Clock::time_point begin = Clock::now();
+    examples::MappedFile font(font_path);
+    if (!font.is_open()) {
+        std::fprintf(stderr, "Unable to open font '%s'.\n", font_path.c_str());
+        return 1;
+    }
+    std::unique_ptr<examples::GlyphAtlas> cold = examples::GlyphCache::Rasterize(font, size, codepoints);
+    double cold_ms = MillisecondsSince(begin);
+    if (!cold) {
+        std::fprintf(stderr, "Unable to rasterize '%s'.\n", font_path.c_str());
+        return 1;
+    }
+
+    begin = Clock::now();
+    sink = examples::GlyphCache::Hash(font.data(), font.size());
+    double hash_ms = MillisecondsSince(begin);
+
+    // The first load through the cache misses and writes the file; the next ones map it.
+    examples::GlyphCache cache(cache_dir);
+    begin = Clock::now();
+    cache.Load(font_path, size, codepoints);
+    double first_ms = MillisecondsSince(begin);
+    bool first_missed = cache.misses() == 1;
+
+    double warm_ms = 0.0;
+    std::unique_ptr<examples::GlyphAtlas> warm;
+    for (int run = 0; run < runs; ++run) {
+        begin = Clock::now();
+        warm = cache.Load(font_path, size, codepoints);
+        // Touch every glyph like uploading the atlas would, so lazily mapped pages count.
+        unsigned long long sum = 0;
+        for (int i = 0; i < warm->width() * warm->height(); i += 4096)
+            sum += warm->pixels()[i];
+        sink = sum;
+        warm_ms += MillisecondsSince(begin);
+    }
+    warm_ms /= runs;
+
+    printf("font: %s, %d px, %u codepoints requested, %u glyphs, %dx%d atlas\n",
+           font_path.c_str(), size, static_cast<unsigned>(codepoints.size()),
+           static_cast<unsigned>(cold->num_glyphs()), cold->width(), cold->height());
+    printf("cold (parse and rasterize): %.2f ms\n", cold_ms);
+    printf("first cached load (%s): %.2f ms\n", first_missed ? "miss, rasterize and write" : "hit", first_ms);
+    printf("warm (map cache file): %.3f ms, of which %.3f ms hashing the font\n", warm_ms, hash_ms);
+    printf("speedup: %.1fx, %u hits, %u misses\n", cold_ms / std::max(warm_ms, 1e-6), cache.hits(), cache.misses());
+
+    if (!warm || !SameAtlas(*cold, *warm)) {
+        std::fprintf(stderr, "The cached atlas differs from the rasterized one.\n");
+        return 1;
+    }
+    return 0;
+}
@@ -10,10 +10,14 @@
 #include <ugdk/action/events.h>
 
 // Graphic
+#include <ugdk/graphic/canvas.h>
 #include <ugdk/graphic/module.h>
-#include <ugdk/ui/drawable/texturedrectangle.h>
-#include <ugdk/ui/node.h>
 
+#include <examples/benchmark.h>
+#include <examples/inputrecord.h>
+#include <examples/quadbatch.h>
+
+#include <algorithm>
 #include <memory>
 #include <functional>
 #include <random>
@@ -40,14 +44,10 @@ class MovableRect :
     public std::enable_shared_from_this<MovableRect>
 {
 public:
-    MovableRect(std::shared_ptr<ui::Node> n, math::Vector2D origin)
-        : node_(n)
-        , origin_(origin)
+    MovableRect(math::Vector2D origin)
+        : origin_(origin)
+        , position_(origin)
     {}
-    ~MovableRect() {
-        if (node_->parent())
-            node_->parent()->RemoveChild(node_.get());
-    }
 
     void Register(std::shared_ptr<input::Joystick> joystick) {
         joystick->event_handler().AddObjectListener(this);
@@ -55,17 +55,26 @@ public:
     }
 
     void Deregister() {
-        connected_joystick_.lock()->event_handler().RemoveObjectListener(this);
+        // Rects created by an input replay aren't registered to any joystick.
+        if (auto joystick = connected_joystick_.lock())
+            joystick->event_handler().RemoveObjectListener(this);
         connected_joystick_.reset();
     }
 
+    void SetAxis(int axis_id, double percentage) {
+        if (axis_id == 0)
+            position_.x = origin_.x + 100 * percentage;
+        else if (axis_id == 1)
+            position_.y = origin_.y + 100 * percentage;
+    }
+
+    // Queues the rect, centered on its position.
+    void Render(examples::QuadBatch& batch) const {
+        batch.Add(graphic::manager()->white_texture(), position_ - box_size * 0.5, box_size, Color(1.0, 1.0, 1.0));
+    }
+
     void Handle(const input::JoystickAxisEvent& ev) override {
-        math::Vector2D current_offset = node_->geometry().offset();
-        if (ev.axis_id == 0)
-            current_offset.x = origin_.x + 100 * ev.axis_status.Percentage();
-        else if (ev.axis_id == 1)
-            current_offset.y = origin_.y + 100 * ev.axis_status.Percentage();
-        node_->geometry().set_offset(current_offset);
+        SetAxis(ev.axis_id, ev.axis_status.Percentage());
     }
 
     void Handle(const input::JoystickDisconnectedEvent& ev) override {
@@ -78,12 +87,27 @@ public:
     }
 
 private:
-    std::shared_ptr<ui::Node> node_;
-    math::Vector2D origin_;
+    math::Vector2D origin_, position_;
     std::weak_ptr<input::Joystick> connected_joystick_;
 };
 
 namespace {
+    std::shared_ptr<MovableRect> CreateRect() {
+        // Sets the point the rect will rotate around.
+        math::Vector2D origin(width_dist(e1), height_dist(e1));
+
+        // Create the logic object that will listen to joystick events. All the
+        // rects are drawn by the same batch.
+        auto rect = std::make_shared<MovableRect>(origin);
+        active_joystick_listeners.push_back(rect);
+        return rect;
+    }
+
+    void CreateRectOnConnection(const input::JoystickConnectedEvent& ev) {
+        auto rect = CreateRect();
+        rect->Register(ev.joystick.lock());
+    }
+
     void ClearJoystickListeners(const action::SceneFinishedEvent&) {
         for (const auto& listener : active_joystick_listeners)
             listener->Deregister();
@@ -95,37 +119,49 @@ namespace {
 }
 
 int main(int argc, char *argv[]) {
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+    examples::InputRecordingOptions input_options = examples::ParseInputRecordingOptions(argc, argv);
+    examples::InputRecorder recorder(input_options.record_path);
+    examples::InputReplay replay(input_options.replay_path);
+
     system::Configuration config;
     config.canvas_size = canvas_size;
+    bench.Configure(config);
     system::Initialize(config);
 
     auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    recorder.Attach(*scene);
     {
-        // Create a node and use it as the render function of the scene.
+        // Every rect goes through one examples::QuadBatch, so they take a single draw call.
         // Note that we purposedly bind the shared_ptr to the render function, so it's deleted along the scene.
-        auto root_node = std::make_shared<ui::Node>();        
-        scene->set_render_function(std::bind(&ui::Node::Render, root_node, std::placeholders::_1));
-
-        // Create a weak reference to the root node so we don't delete it at the wrong time.
-        std::weak_ptr<ui::Node> root_weak = root_node;
+        auto batch = std::make_shared<examples::QuadBatch>();
+        scene->set_render_function(bench.Render([batch](graphic::Canvas& canvas) {
+            batch->Clear();
+            for (const auto& rect : active_joystick_listeners)
+                rect->Render(*batch);
+            batch->Draw(canvas);
+        }));
 
         // We don't check for the already connected joysticks at the moment because there's none:
         // Even joysticks "already connected" when our application starts goes through the joystick connection logic.
-        scene->event_handler().AddListener<ugdk::input::JoystickConnectedEvent>([root_weak](const ugdk::input::JoystickConnectedEvent& ev) {
-
-            // Sets the point the rect will rotate around.
-            math::Vector2D origin(width_dist(e1), height_dist(e1));
-
-            // Create the visual.
-            auto joystick_node = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), box_size));
-            joystick_node->drawable()->set_hotspot(ui::HookPoint::CENTER);
-            root_weak.lock()->AddChild(joystick_node);
-            joystick_node->geometry().set_offset(origin);
-
-            // Create the logic object that will listen to joystick events.
-            auto rect = std::make_shared<MovableRect>(joystick_node, origin);
-            rect->Register(ev.joystick.lock());
-            active_joystick_listeners.push_back(rect);
+        scene->event_handler().AddListener(CreateRectOnConnection);
+
+        // Replayed joysticks get a rect that's moved directly by the recorded axis values.
+        auto replayed_rects = std::make_shared<std::vector<std::weak_ptr<MovableRect>>>();
+        replay.Attach(*scene, [replayed_rects](const examples::InputRecord& record) {
+            if (record.type == examples::InputRecord::JOYSTICK_CONNECTED) {
+                replayed_rects->resize(std::max<std::size_t>(replayed_rects->size(), record.device + 1));
+                (*replayed_rects)[record.device] = CreateRect();
+                return;
+            }
+            auto rect = record.device < replayed_rects->size() ? (*replayed_rects)[record.device].lock() : nullptr;
+            if (!rect)
+                return;
+            if (record.type == examples::InputRecord::JOYSTICK_AXIS)
+                rect->SetAxis(record.a, record.b / 32767.0);
+            else if (record.type == examples::InputRecord::JOYSTICK_DISCONNECTED)
+                active_joystick_listeners.remove(rect);
         });
 
         // Clean yourself:
@@ -10,16 +10,42 @@
 #include <ugdk/action/events.h>
 
 // Graphic
+#include <ugdk/graphic/geometry.h>
 #include <ugdk/graphic/module.h>
 #include <ugdk/ui/drawable/texturedrectangle.h>
 #include <ugdk/ui/node.h>
 #include <ugdk/text/module.h>
-#include <ugdk/text/label.h>
 
+// Counts every allocation of the program, to compare the pooled and unpooled churn,
+// and accounts them to the module given by the MemoryTagScopes below.
+#define EXAMPLES_ALLOCATION_COUNTER_IMPLEMENTATION
+#include <examples/allocationcounter.h>
+#include <examples/assetloader.h>
+#include <examples/atlastext.h>
+#include <examples/benchmark.h>
+#include <examples/clock.h>
+#include <examples/inputrecord.h>
+#include <examples/labelbuffer.h>
+#include <examples/loadingscene.h>
+#include <examples/memoryoverlay.h>
+#include <examples/numberlabel.h>
+#include <examples/poolresource.h>
+#include <examples/postedevents.h>
+#include <examples/processmemory.h>
+#include <examples/profiler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <functional>
 #include <random>
+#include <thread>
+#include <tuple>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 using namespace ugdk;
 
@@ -28,6 +54,7 @@ class JoystickDisplay;
 namespace {
     const math::Vector2D box_size(50.0, 50.0);
     const math::Vector2D canvas_size(1280.0, 720.0);
+    const double display_height = 100.0;
     const double display_spacing = 5.0;
     text::Font* default_font = nullptr;
 
@@ -35,52 +62,104 @@ namespace {
     auto snprintf = sprintf_s;
 #endif
 
-    std::list<std::shared_ptr<JoystickDisplay>> active_joystick_listeners;
+    typedef std::list<std::shared_ptr<JoystickDisplay>> DisplayList;
+    DisplayList active_joystick_listeners;
+    void RemoveDisplay(JoystickDisplay* display);
+
+    // --show-values shows the value of every axis as a number, refreshed every frame.
+    bool show_values = false;
+    // The numbers of every display, once their font is loaded. The displays keep it
+    // too, and it's dropped with them, before the graphic module is released.
+    std::shared_ptr<examples::LabelBuffer> value_labels;
 
-    std::shared_ptr<ui::Node> CreateLabelNode(const std::string& str, const math::Vector2D& position, ui::HookPoint hook = ui::HookPoint::TOP_LEFT) {
-        auto node = std::make_shared<ui::Node>(MakeUnique<text::Label>(str, default_font));
-        node->drawable()->set_hotspot(hook);
-        node->geometry().set_offset(position);
-        return node;
+    // Adds child, and the child_nodes nodes of its subtree, under parent. The widgets
+    // add their nodes through this so they know the size of their subtree.
+    void AddCountedChild(ui::Node& parent, const std::shared_ptr<ui::Node>& child, std::size_t& num_nodes,
+                         std::size_t child_nodes = 1) {
+        parent.AddChild(child);
+        num_nodes += child_nodes;
     }
 }
 
 class AxisSlider {
 public:
     AxisSlider()
-        : node_(new ui::Node)
+        : node_(examples::MakePooledShared<ui::Node>())
+        , value_(value_capacity())
+        , labels_(nullptr)
+        , label_(0)
+        , percentage_(0.0)
+        , num_nodes_(1)
     {
-        auto background = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), 10.0)));
+        auto background = examples::MakePooledShared<ui::Node>(examples::MakePooledUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), 10.0)));
         background->drawable()->set_hotspot(ui::HookPoint::CENTER);
         background->effect().set_color(Color(0.5, 0.5, 0.5));
-        node_->AddChild(background);
+        AddCountedChild(*node_, background, num_nodes_);
 
-        slider_ = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(5.0, 10.0)));
+        slider_ = examples::MakePooledShared<ui::Node>(examples::MakePooledUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(5.0, 10.0)));
         slider_->drawable()->set_hotspot(ui::HookPoint::CENTER);
         slider_->effect().set_color(Color(0.0, 1.0, 0.0));
-        node_->AddChild(slider_);
+        AddCountedChild(*node_, slider_, num_nodes_);
     }
 
     void SetPercentage(double percentage) {
         slider_->geometry().set_offset(math::Vector2D(percentage * width() / 2, 0.0));
+        percentage_ = percentage;
+    }
+
+    // Shows the number under the slider, whose top center is at position in the
+    // space labels is drawn in, updated by RefreshValue. It isn't in the nodes:
+    // labels draws the numbers of every display at once.
+    void ShowValue(examples::LabelBuffer* labels, const math::Vector2D& position) {
+        labels_ = labels;
+        label_ = labels_->Add(position);
+        RefreshValue();
+    }
+
+    void MoveValue(const math::Vector2D& position) {
+        if (labels_)
+            labels_->Move(label_, position);
     }
 
-    double width() const { return 50.0; }
+    void HideValue() {
+        if (labels_)
+            labels_->Remove(label_);
+        labels_ = nullptr;
+    }
+
+    void RefreshValue() {
+        if (!labels_)
+            return;
+        value_.Set(percentage_ * 100.0, 0, "%");
+        labels_->Set(label_, value_.text());
+    }
+
+    static double width() { return 50.0; }
+    static std::size_t value_capacity() { return 5; }
+    // Where the top center of the number goes, from the center of the slider.
+    static math::Vector2D value_offset() { return math::Vector2D(0.0, 7.0); }
 
     std::shared_ptr<ui::Node> node() { return node_; }
+    std::size_t num_nodes() const { return num_nodes_; }
 private:
     std::shared_ptr<ui::Node> node_, slider_;
+    examples::NumberLabel value_;
+    examples::LabelBuffer* labels_;
+    examples::LabelBuffer::Label label_;
+    double percentage_;
+    std::size_t num_nodes_;
 };
 
 class ButtonDisplay {
 public:
     ButtonDisplay()
-        : node_(new ui::Node) {
+        : node_(examples::MakePooledShared<ui::Node>())
+        , num_nodes_(1) {
 
-        display_ = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), height())));
+        display_ = examples::MakePooledShared<ui::Node>(examples::MakePooledUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), height())));
         display_->drawable()->set_hotspot(ui::HookPoint::CENTER);
         display_->effect().set_color(Color(0.5, 0.5, 0.5));
-        node_->AddChild(display_);
+        AddCountedChild(*node_, display_, num_nodes_);
     }
 
     void set_active(bool active) {
@@ -88,47 +167,118 @@ public:
                                             : Color(0.5, 0.5, 0.5));
     }
 
-    double width() const { return 20.0; }
-    double height() const { return 20.0; }
+    static double width() { return 20.0; }
+    static double height() { return 20.0; }
 
     std::shared_ptr<ui::Node> node() { return node_; }
+    std::size_t num_nodes() const { return num_nodes_; }
 private:
     std::shared_ptr<ui::Node> node_, display_;
+    std::size_t num_nodes_;
 };
 
 class HatDisplay {
 public:
     HatDisplay()
-        : node_(new ui::Node) {
-        auto background = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), height())));
+        : node_(examples::MakePooledShared<ui::Node>())
+        , num_nodes_(1) {
+        auto background = examples::MakePooledShared<ui::Node>(examples::MakePooledUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), height())));
         background->drawable()->set_hotspot(ui::HookPoint::CENTER);
         background->effect().set_color(Color(0.5, 0.5, 0.5));
-        node_->AddChild(background);
+        AddCountedChild(*node_, background, num_nodes_);
 
-        slider_ = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(5.0, 5.0)));
+        slider_ = examples::MakePooledShared<ui::Node>(examples::MakePooledUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(5.0, 5.0)));
         slider_->drawable()->set_hotspot(ui::HookPoint::CENTER);
         slider_->effect().set_color(Color(0.0, 1.0, 0.0));
-        node_->AddChild(slider_);
+        AddCountedChild(*node_, slider_, num_nodes_);
     }
 
     void set_status(input::HatStatus status) {
-        math::Vector2D offset;
-        if (status.HasLeft()) offset.x -= width() / 2;
-        if (status.HasRight()) offset.x += width() / 2;
-        if (status.HasUp()) offset.y -= height() / 2;
-        if (status.HasDown()) offset.y += height() / 2;
-        slider_->geometry().set_offset(offset);
+        set_direction((status.HasRight() ? 1 : 0) - (status.HasLeft() ? 1 : 0),
+                      (status.HasDown() ? 1 : 0) - (status.HasUp() ? 1 : 0));
+    }
+
+    // dx and dy are -1, 0 or 1.
+    void set_direction(int dx, int dy) {
+        slider_->geometry().set_offset(math::Vector2D(dx * width() / 2, dy * height() / 2));
     }
 
-    double width() const { return 20.0; }
-    double height() const { return 20.0; }
+    static double width() { return 20.0; }
+    static double height() { return 20.0; }
 
     std::shared_ptr<ui::Node> node() { return node_; }
+    std::size_t num_nodes() const { return num_nodes_; }
 private:
     std::shared_ptr<ui::Node> node_, slider_;
+    std::size_t num_nodes_;
 };
 
 
+// Where each widget of a display goes. Every joystick with the same number of axes,
+// buttons and hats shares one layout, so it's computed once per kind of device.
+// Layouts live until the program exits.
+struct DisplayLayout {
+    struct Section {
+        std::string title;
+        math::Vector2D title_position;
+        std::vector<math::Vector2D> positions;
+    };
+
+    // A string shown at the same place in every display, aligned as in
+    // examples::AtlasFont::AddText.
+    struct Text {
+        std::string text;
+        math::Vector2D position, align;
+    };
+
+    DisplayLayout(int num_axes, int num_buttons, int num_hats) {
+        double xoffset = 0.0;
+        axes = MakeSection("Axis", num_axes, AxisSlider::width(), 80.0, xoffset);
+        buttons = MakeSection("Buttons", num_buttons, ButtonDisplay::width(), 75.0, xoffset);
+        hats = MakeSection("Hats", num_hats, HatDisplay::width(), 85.0, xoffset);
+        // Titles at their top-left corner, indices centered above or on their widget.
+        AddTexts(axes, math::Vector2D(0.0, -10.0), math::Vector2D(0.5, 1.0));
+        AddTexts(buttons, math::Vector2D(0.0, 0.0), math::Vector2D(0.5, 0.5));
+        AddTexts(hats, math::Vector2D(0.0, -15.0), math::Vector2D(0.5, 1.0));
+    }
+
+    void AddTexts(const Section& section, const math::Vector2D& index_offset, const math::Vector2D& index_align) {
+        if (section.positions.empty())
+            return;
+        Text title = { section.title, section.title_position, math::Vector2D() };
+        texts.push_back(title);
+        for (std::size_t i = 0; i < section.positions.size(); ++i) {
+            Text index = { std::to_string(i), section.positions[i] + index_offset, index_align };
+            texts.push_back(index);
+        }
+    }
+
+    static Section MakeSection(const std::string& title, int count, double width, double y, double& xoffset) {
+        Section section;
+        if (count <= 0)
+            return section;
+        section.title = title;
+        section.title_position = math::Vector2D(xoffset + 5.0, 30.0);
+        for (int i = 0; i < count; ++i) {
+            section.positions.push_back(math::Vector2D(xoffset + width / 2, y));
+            xoffset += width + 5.0;
+        }
+        xoffset += 10.0;
+        return section;
+    }
+
+    static std::shared_ptr<const DisplayLayout> Get(int num_axes, int num_buttons, int num_hats) {
+        static std::map<std::tuple<int, int, int>, std::shared_ptr<const DisplayLayout>> cache;
+        auto& layout = cache[std::make_tuple(num_axes, num_buttons, num_hats)];
+        if (!layout)
+            layout = std::make_shared<DisplayLayout>(num_axes, num_buttons, num_hats);
+        return layout;
+    }
+
+    Section axes, buttons, hats;
+    std::vector<Text> texts;
+};
+
 class JoystickDisplay :
     public system::Listener<input::JoystickAxisEvent>,
     public system::Listener<input::JoystickButtonPressedEvent>,
@@ -139,86 +289,68 @@ class JoystickDisplay :
 {
 public:
     JoystickDisplay(std::shared_ptr<input::Joystick> joystick)
-        : node_(new ui::Node)
+        : node_(examples::MakePooledShared<ui::Node>())
         , joystick_(joystick)
     {
-        joystick_->event_handler().AddObjectListener(this);
-
-        auto background = std::make_shared<ui::Node>(MakeUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), height())));
-        background->effect().set_color(Color(0.1, 0.1, 0.1));
-        node_->AddChild(background);
+        {
+            examples::MemoryTagScope tag(examples::MemoryTag::INPUT);
+            joystick_->event_handler().AddObjectListener(this);
+        }
 
         char description[250];
         snprintf(description, 250, "Joystick [%p] -- %d Axis, %d Hat, %d Balls, %d Buttons",
                  joystick.get(),
                  joystick->NumAxes(), joystick->NumHats(), joystick->NumTrackballs(), joystick->NumButtons());
-        node_->AddChild(CreateLabelNode(description, math::Vector2D(0.0, 0.0)));
-
-        double xoffset = 0.0;
-
-        if (joystick->NumAxes() > 0) {
-            node_->AddChild(CreateLabelNode("Axis", math::Vector2D(xoffset + 5.0, 30.0)));
-            axis_sliders_.resize(joystick->NumAxes());
-            for (size_t i = 0; i < axis_sliders_.size(); ++i) {
-                double width = axis_sliders_[i].width();
-
-                axis_sliders_[i].node()->AddChild(CreateLabelNode(std::to_string(i), math::Vector2D(0.0, -10.0), ui::HookPoint::BOTTOM));
-                axis_sliders_[i].node()->geometry().set_offset(math::Vector2D(xoffset + width / 2, 80));
-                node_->AddChild(axis_sliders_[i].node());
-
-                xoffset += width + 5.0;
-            }
-            xoffset += 10.0;
-        }
-
-        if (joystick->NumButtons() > 0) {
-            node_->AddChild(CreateLabelNode("Buttons", math::Vector2D(xoffset + 5.0, 30.0)));
-            button_displays_.resize(joystick->NumButtons());
-            for (size_t i = 0; i < button_displays_.size(); ++i) {
-                double width = button_displays_[i].width();
-
-                button_displays_[i].node()->AddChild(CreateLabelNode(std::to_string(i), math::Vector2D(0.0, 0.0), ui::HookPoint::CENTER));
-                button_displays_[i].node()->geometry().set_offset(math::Vector2D(xoffset + width / 2, 75));
-                node_->AddChild(button_displays_[i].node());
-
-                xoffset += width + 5.0;
-            }
-            xoffset += 10.0;
-        }
-
-        if (joystick->NumHats() > 0) {
-            node_->AddChild(CreateLabelNode("Hats", math::Vector2D(xoffset + 5.0, 30.0)));
-            hat_displays_.resize(joystick->NumHats());
-            for (size_t i = 0; i < hat_displays_.size(); ++i) {
-                double width = hat_displays_[i].width();
-
-                hat_displays_[i].node()->AddChild(CreateLabelNode(std::to_string(i), math::Vector2D(0.0, -15.0), ui::HookPoint::BOTTOM));
-                hat_displays_[i].node()->geometry().set_offset(math::Vector2D(xoffset + width / 2, 85));
-                node_->AddChild(hat_displays_[i].node());
+        Build(*DisplayLayout::Get(joystick->NumAxes(), joystick->NumButtons(), joystick->NumHats()), description);
+    }
 
-                xoffset += width + 5.0;
-            }
-            xoffset += 10.0;
+    // A display that isn't attached to any device. It's driven directly through
+    // SetAxis, SetButton and SetHat, or by the joystick events raised on handler.
+    JoystickDisplay(const DisplayLayout& layout, const std::string& description,
+                    system::EventHandler* handler = nullptr)
+        : node_(examples::MakePooledShared<ui::Node>())
+        , handler_(handler)
+    {
+        if (handler_) {
+            examples::MemoryTagScope tag(examples::MemoryTag::INPUT);
+            handler_->AddObjectListener(this);
         }
+        Build(layout, description);
     }
 
     ~JoystickDisplay() {
+        for (AxisSlider& slider : axis_sliders_)
+            slider.HideValue();
         if (joystick_)
             joystick_->event_handler().RemoveObjectListener(this);
+        if (handler_)
+            handler_->RemoveObjectListener(this);
         if (node_->parent())
             node_->parent()->RemoveChild(node_.get());
     }
 
+    void SetAxis(int axis_id, double percentage) {
+        axis_sliders_[axis_id].SetPercentage(percentage);
+    }
+
+    void SetButton(int button, bool active) {
+        button_displays_[button].set_active(active);
+    }
+
+    void SetHat(int hat_id, int dx, int dy) {
+        hat_displays_[hat_id].set_direction(dx, dy);
+    }
+
     void Handle(const input::JoystickAxisEvent& ev) override {
-        axis_sliders_[ev.axis_id].SetPercentage(ev.axis_status.Percentage());
+        SetAxis(ev.axis_id, ev.axis_status.Percentage());
     }
 
     void Handle(const input::JoystickButtonPressedEvent& ev) override {
-        button_displays_[ev.button].set_active(true);
+        SetButton(ev.button, true);
     }
 
     void Handle(const input::JoystickButtonReleasedEvent& ev) override {
-        button_displays_[ev.button].set_active(false);
+        SetButton(ev.button, false);
     }
 
     void Handle(const input::JoystickHatEvent& ev) override {
@@ -226,23 +358,103 @@ public:
     }    
 
     void Handle(const input::JoystickDisconnectedEvent& ev) override {
+        // Like a joystick, the handler that raised this goes away with its device.
         joystick_.reset();
+        handler_ = nullptr;
         // Removing the object from the listeners list clears the only shared_ptr to
         // this, so the object is destroyed.
-        active_joystick_listeners.remove(shared_from_this());
+        RemoveDisplay(this);
     }
 
     std::shared_ptr<ui::Node> node() { return node_; }
     double width() const { return 1000.0; }
-    double height() const { return 100.0; }
+
+    // Places the display at offset in its parent, which is also the space the
+    // values are drawn in, and moves the values along.
+    void set_offset(const math::Vector2D& offset) {
+        node_->geometry().set_offset(offset);
+        for (std::size_t i = 0; i < axis_sliders_.size(); ++i)
+            axis_sliders_[i].MoveValue(ValuePosition(i));
+    }
+    double height() const { return display_height; }
+
+    // Called every frame with --show-values, whether the axes moved or not.
+    void RefreshValues() {
+        for (AxisSlider& slider : axis_sliders_)
+            slider.RefreshValue();
+    }
+
+    int num_axes() const { return static_cast<int>(axis_sliders_.size()); }
+    int num_buttons() const { return static_cast<int>(button_displays_.size()); }
+    int num_hats() const { return static_cast<int>(hat_displays_.size()); }
+
+    // Nodes in this display's subtree, counted by Build as it adds them.
+    std::size_t num_nodes() const { return num_nodes_; }
+
+    // Queues the description, titles and indices of the display, whose top-left
+    // corner is at offset in the batch's space.
+    void AddText(examples::QuadBatch& batch, const examples::AtlasFont& font, const math::Vector2D& offset) const {
+        const Color white(1.0, 1.0, 1.0);
+        font.AddText(batch, description_, offset, white);
+        for (const DisplayLayout::Text& text : layout_->texts)
+            font.AddText(batch, text.text, offset + text.position, white, text.align);
+    }
+
+    // Position of this display in active_joystick_listeners, kept so removal doesn't
+    // need to search the list.
+    DisplayList::iterator slot;
+    std::size_t slot_index;
 
 private:
+    math::Vector2D ValuePosition(std::size_t axis) const {
+        return node_->geometry().offset() + layout_->axes.positions[axis] + AxisSlider::value_offset();
+    }
+
+    // The text isn't in the nodes: the scene draws the text of every display at
+    // once, with AddText, and the values of every display from value_labels.
+    void Build(const DisplayLayout& layout, const std::string& description) {
+        layout_ = &layout;
+        value_labels_ = value_labels;
+        {
+            examples::MemoryTagScope tag(examples::MemoryTag::TEXT);
+            description_ = description;
+        }
+        auto background = examples::MakePooledShared<ui::Node>(examples::MakePooledUnique<ui::TexturedRectangle>(graphic::manager()->white_texture(), math::Vector2D(width(), height())));
+        background->effect().set_color(Color(0.1, 0.1, 0.1));
+        num_nodes_ = 1;
+        AddCountedChild(*node_, background, num_nodes_);
+
+        axis_sliders_.resize(layout.axes.positions.size());
+        for (size_t i = 0; i < axis_sliders_.size(); ++i) {
+            axis_sliders_[i].node()->geometry().set_offset(layout.axes.positions[i]);
+            if (value_labels_)
+                axis_sliders_[i].ShowValue(value_labels_.get(), ValuePosition(i));
+            AddCountedChild(*node_, axis_sliders_[i].node(), num_nodes_, axis_sliders_[i].num_nodes());
+        }
+
+        button_displays_.resize(layout.buttons.positions.size());
+        for (size_t i = 0; i < button_displays_.size(); ++i) {
+            button_displays_[i].node()->geometry().set_offset(layout.buttons.positions[i]);
+            AddCountedChild(*node_, button_displays_[i].node(), num_nodes_, button_displays_[i].num_nodes());
+        }
+
+        hat_displays_.resize(layout.hats.positions.size());
+        for (size_t i = 0; i < hat_displays_.size(); ++i) {
+            hat_displays_[i].node()->geometry().set_offset(layout.hats.positions[i]);
+            AddCountedChild(*node_, hat_displays_[i].node(), num_nodes_, hat_displays_[i].num_nodes());
+        }
+    }
+
     std::shared_ptr<ui::Node> node_;
-    math::Vector2D origin_;
     std::shared_ptr<input::Joystick> joystick_;
+    system::EventHandler* handler_ = nullptr;
+    const DisplayLayout* layout_ = nullptr;
+    std::string description_;
     std::vector<AxisSlider> axis_sliders_;
     std::vector<ButtonDisplay> button_displays_;
     std::vector<HatDisplay> hat_displays_;
+    std::size_t num_nodes_ = 0;
+    std::shared_ptr<examples::LabelBuffer> value_labels_;
 };
 
 namespace {
@@ -250,34 +462,594 @@ namespace {
         // This list contains the only copies of the shared_ptr, so the objects are also
         // destroyed at this point.
         active_joystick_listeners.clear();
+        value_labels.reset();
+    }
+
+    double DisplayTop(const JoystickDisplay& display) {
+        return 10.0 + display.slot_index * (display.height() + display_spacing);
+    }
+
+    void PlaceDisplay(JoystickDisplay& display) {
+        display.set_offset(math::Vector2D(10.0, DisplayTop(display)));
+    }
+
+    // How far down the stack of displays is scrolled, since it can be much taller
+    // than the canvas.
+    double scroll = 0.0;
+
+    void ScrollBy(double delta, double view_height) {
+        double stack_height = 10.0 + active_joystick_listeners.size() * (display_height + display_spacing);
+        scroll = std::max(0.0, std::min(scroll + delta, stack_height - view_height));
+    }
+
+    // The mouse wheel scrolls by a few lines, Page Up and Page Down by a screen.
+    void ScrollOnWheel(const input::MouseWheelEvent& ev) {
+        ScrollBy(-ev.scroll.y * 40.0, canvas_size.y);
+    }
+
+    void ScrollOnKeys(const input::KeyPressedEvent& ev) {
+        if (ev.scancode == input::Scancode::PAGEUP)
+            ScrollBy(-canvas_size.y, canvas_size.y);
+        else if (ev.scancode == input::Scancode::PAGEDOWN)
+            ScrollBy(canvas_size.y, canvas_size.y);
+        else if (ev.scancode == input::Scancode::HOME)
+            ScrollBy(-scroll, canvas_size.y);
     }
 
-    void RepositionDisplays() {
-        double yoffset = 10.0;
+    struct CullStats {
+        unsigned drawn_displays, culled_displays;
+        std::size_t drawn_nodes, culled_nodes;
+        std::size_t glyphs, text_draw_calls;
+    };
+
+    // Deactivates the displays that are entirely outside [top, bottom), in root
+    // coordinates, so Node::Render skips their whole subtrees.
+    CullStats CullDisplays(double top, double bottom) {
+        CullStats stats = CullStats();
         for (const auto& display : active_joystick_listeners) {
-            display->node()->geometry().set_offset(math::Vector2D(10.0, yoffset));
-            yoffset += display->height() + display_spacing;
+            double display_top = DisplayTop(*display);
+            bool visible = display_top < bottom && display_top + display->height() > top;
+            display->node()->set_active(visible);
+            if (visible) {
+                stats.drawn_displays += 1;
+                stats.drawn_nodes += display->num_nodes();
+            } else {
+                stats.culled_displays += 1;
+                stats.culled_nodes += display->num_nodes();
+            }
+        }
+        return stats;
+    }
+
+    // Averages the render time and prints it with the culling counters every 120 frames.
+    class RenderReport {
+      public:
+        RenderReport() : frames_(0), render_ms_(0.0) {}
+
+        void EndFrame(double render_ms, bool culling, const CullStats& stats) {
+            render_ms_ += render_ms;
+            if (++frames_ < 120)
+                return;
+            if (culling)
+                printf("render: %.3f ms/frame, %u displays drawn (%u nodes), %u culled (%u nodes)",
+                       render_ms_ / frames_, stats.drawn_displays, static_cast<unsigned>(stats.drawn_nodes),
+                       stats.culled_displays, static_cast<unsigned>(stats.culled_nodes));
+            else
+                printf("render: %.3f ms/frame, %u displays drawn, culling off",
+                       render_ms_ / frames_, static_cast<unsigned>(active_joystick_listeners.size()));
+            printf(", text %u glyphs in %u draw calls\n", static_cast<unsigned>(stats.glyphs),
+                   static_cast<unsigned>(stats.text_draw_calls));
+            frames_ = 0;
+            render_ms_ = 0.0;
+        }
+
+      private:
+        unsigned frames_;
+        double render_ms_;
+    };
+
+    // Refreshes the number of every axis each frame. Every 120 frames, prints what
+    // the value labels wrote to their vertex buffer, and the allocations made by
+    // the whole frame, from the start of the update to the end of the render.
+    //
+    // After the first 120 frames, the displays are all built and a frame should
+    // allocate nothing, so one that does is reported as a failure. Not when checked
+    // is false: churning virtual joysticks allocates every frame on purpose.
+    class ValueReport {
+      public:
+        explicit ValueReport(bool checked)
+            : checked_(checked)
+            , warmed_up_(false)
+            , failed_(false)
+            , frames_(0)
+            , allocations_(0)
+            , frame_begin_(examples::AllocationStats())
+        {}
+
+        void BeginFrame() {
+            frame_begin_ = examples::CurrentAllocationStats();
+        }
+
+        void Refresh() {
+            for (const auto& display : active_joystick_listeners)
+                display->RefreshValues();
+        }
+
+        // labels may be null, when the value font couldn't be loaded.
+        void EndFrame(examples::LabelBuffer* labels) {
+            allocations_ += (examples::CurrentAllocationStats() - frame_begin_).allocations;
+            if (++frames_ < 120)
+                return;
+            examples::LabelBuffer::Stats stats = labels ? labels->stats() : examples::LabelBuffer::Stats();
+            printf("values: %.1f glyphs (%.0f bytes) written/frame in %llu uploads, %llu allocations in %u frames%s\n",
+                   double(stats.written_glyphs) / frames_, double(stats.written_bytes) / frames_, stats.uploads,
+                   allocations_, frames_, warmed_up_ ? "" : " (warm-up)");
+            if (checked_ && warmed_up_ && allocations_ > 0) {
+                fprintf(stderr, "values: FAILED, %llu allocations in %u frames after warm-up, expected none.\n",
+                        allocations_, frames_);
+                failed_ = true;
+            }
+            if (labels)
+                labels->ResetStats();
+            warmed_up_ = true;
+            frames_ = 0;
+            allocations_ = 0;
+        }
+
+        bool failed() const { return failed_; }
+
+      private:
+        bool checked_, warmed_up_, failed_;
+        unsigned frames_;
+        unsigned long long allocations_;
+        examples::AllocationStats frame_begin_;
+    };
+
+    // Displays are stacked in connection order, so a new one only needs its own position.
+    void AddDisplay(const std::shared_ptr<JoystickDisplay>& display) {
+        display->slot_index = active_joystick_listeners.size();
+        display->slot = active_joystick_listeners.insert(active_joystick_listeners.end(), display);
+        PlaceDisplay(*display);
+    }
+
+    // Only the displays after the removed one move up.
+    void RemoveDisplay(JoystickDisplay* display) {
+        auto next = active_joystick_listeners.erase(display->slot);
+        for (; next != active_joystick_listeners.end(); ++next) {
+            (*next)->slot_index -= 1;
+            PlaceDisplay(**next);
         }
     }
 }
 
+// One input of a virtual device, as the driver generates it, before it becomes
+// the input::Joystick*Event a real device would raise.
+struct VirtualJoystickInput {
+    enum Kind { AXIS, BUTTON, HAT };
+
+    int device;
+    Kind kind;
+    int index;
+    double value;  // Axis percentage, or 1/0 for pressed/released buttons.
+    int dx, dy;    // Hat direction.
+};
+
+// The events the driver's threads post to one virtual device, one queue per event
+// type. Events of different types may be raised in another order than they were
+// posted in; the input is random anyway, so only which random state shows changes.
+struct PostedJoystickEvents {
+    explicit PostedJoystickEvents(std::size_t capacity)
+        : axes(capacity), presses(capacity), releases(capacity), hats(capacity)
+    {}
+
+    void Post(const input::JoystickAxisEvent& ev) { axes.Post(ev); }
+    void Post(const input::JoystickButtonPressedEvent& ev) { presses.Post(ev); }
+    void Post(const input::JoystickButtonReleasedEvent& ev) { releases.Post(ev); }
+    void Post(const input::JoystickHatEvent& ev) { hats.Post(ev); }
+
+    std::size_t Drain(system::EventHandler& handler) {
+        return axes.Drain(handler) + presses.Drain(handler) + releases.Drain(handler) + hats.Drain(handler);
+    }
+
+    std::size_t dropped() const {
+        return axes.dropped() + presses.dropped() + releases.dropped() + hats.dropped();
+    }
+
+    examples::PostedEvents<input::JoystickAxisEvent> axes;
+    examples::PostedEvents<input::JoystickButtonPressedEvent> presses;
+    examples::PostedEvents<input::JoystickButtonReleasedEvent> releases;
+    examples::PostedEvents<input::JoystickHatEvent> hats;
+};
+
+// Plugs fake devices into the display and feeds them random input every frame,
+// so connection latency, handler cost and frame time can be measured against
+// the number of devices without real hardware. Each device has an EventHandler of
+// its own, standing in for input::Joystick::event_handler(), and its input is
+// raised there as input::Joystick*Events, so the handler cost includes dispatch.
+// Devices are unplugged with a JoystickDisconnectedEvent. Enabled with:
+//   --virtual-joysticks=N         number of devices plugged at startup
+//   --virtual-layout=AxBxH        axes, buttons and hats of each device (default 6x12x1)
+//   --virtual-events=E            events per device per frame (default 10)
+//   --virtual-threads=T           generate the input on T threads, posting the events to
+//                                 the main thread, instead of generating it on the main thread
+//   --virtual-churn=C             unplug C devices and plug new ones every frame, and
+//                                 report allocations, allocator time and fragmentation
+class VirtualJoystickDriver {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    VirtualJoystickDriver(int argc, char* argv[])
+        : num_devices_(0)
+        , num_axes_(6), num_buttons_(12), num_hats_(1)
+        , events_per_frame_(10)
+        , num_threads_(0)
+        , churn_(0)
+        , next_churn_(0)
+        , plugged_(0)
+        , root_(nullptr)
+        , random_(1234)
+        , running_(false)
+        , frames_(0), events_(0)
+        , handler_time_(0.0), frame_time_(0.0)
+    {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strncmp(argv[i], "--virtual-joysticks=", 20) == 0)
+                num_devices_ = std::atoi(argv[i] + 20);
+            else if (std::strncmp(argv[i], "--virtual-layout=", 17) == 0)
+                std::sscanf(argv[i] + 17, "%dx%dx%d", &num_axes_, &num_buttons_, &num_hats_);
+            else if (std::strncmp(argv[i], "--virtual-events=", 17) == 0)
+                events_per_frame_ = std::atoi(argv[i] + 17);
+            else if (std::strncmp(argv[i], "--virtual-threads=", 18) == 0)
+                num_threads_ = std::atoi(argv[i] + 18);
+            else if (std::strncmp(argv[i], "--virtual-churn=", 16) == 0)
+                churn_ = std::atoi(argv[i] + 16);
+        }
+        churn_ = std::max(0, std::min(churn_, num_devices_));
+        if (churn_ > 0)
+            examples::EnableAllocationTiming(true);
+        num_axes_ = std::max(num_axes_, 0);
+        num_buttons_ = std::max(num_buttons_, 0);
+        num_hats_ = std::max(num_hats_, 0);
+        // Devices without any axis, button or hat have no input to generate.
+        if (num_axes_ + num_buttons_ + num_hats_ == 0)
+            events_per_frame_ = 0;
+        num_threads_ = std::max(num_threads_, 0);
+    }
+
+    ~VirtualJoystickDriver() {
+        running_ = false;
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    bool enabled() const { return num_devices_ > 0; }
+    bool churning() const { return churn_ > 0; }
+
+    // Plugs a device, returning how long the connection took in milliseconds.
+    double Plug(ui::Node& root) {
+        Clock::time_point begin = Clock::now();
+        handlers_.emplace_back(new system::EventHandler);
+        devices_.push_back(CreateDisplay(root, *handlers_.back()));
+        // Each queue has room for four frames of the device's input.
+        if (num_threads_ > 0)
+            posted_.emplace_back(new PostedJoystickEvents(std::max(4 * events_per_frame_, 1)));
+        return examples::Milliseconds(begin, Clock::now());
+    }
+
+    void PlugAll(ui::Node& root) {
+        root_ = &root;
+        double total = 0.0;
+        for (int i = 0; i < num_devices_; ++i)
+            total += Plug(root);
+        allocations_ = examples::CurrentAllocationStats();
+        printf("Plugged %d virtual joysticks, %.3f ms per connection.\n", num_devices_, total / num_devices_);
+
+        // Each thread produces the input of every num_threads_-th device.
+        running_ = true;
+        for (int t = 0; t < num_threads_; ++t) {
+            threads_.emplace_back([this, t] {
+                examples::MemoryTagScope tag(examples::MemoryTag::INPUT);
+                std::minstd_rand random(t + 1);
+                while (running_) {
+                    for (int device = t; device < num_devices_; device += num_threads_)
+                        for (int e = 0; e < events_per_frame_; ++e)
+                            Send(Generate(random, device), *posted_[device]);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                }
+            });
+        }
+    }
+
+    // Called once per frame, on the main thread.
+    void Update() {
+        Churn();
+        Clock::time_point begin = Clock::now();
+        examples::MemoryTagScope tag(examples::MemoryTag::INPUT);
+        if (num_threads_ > 0) {
+            for (int device = 0; device < num_devices_; ++device)
+                events_ += posted_[device]->Drain(*handlers_[device]);
+        } else {
+            for (int device = 0; device < num_devices_; ++device)
+                for (int e = 0; e < events_per_frame_; ++e)
+                    Send(Generate(random_, device), *handlers_[device]);
+            events_ += num_devices_ * events_per_frame_;
+        }
+        Clock::time_point end = Clock::now();
+        handler_time_ += examples::Milliseconds(begin, end);
+
+        if (frames_ > 0)
+            frame_time_ += examples::Milliseconds(last_frame_, end);
+        last_frame_ = end;
+        if (++frames_ % 120 == 0) {
+            printf("%u devices: %.3f ms/frame, %.1f events/frame, %.1f ns/event, %u dropped\n",
+                   static_cast<unsigned>(active_joystick_listeners.size()),
+                   frame_time_ / (frames_ - 1), double(events_) / frames_,
+                   events_ > 0 ? 1e6 * handler_time_ / events_ : 0.0,
+                   static_cast<unsigned>(Dropped()));
+            if (churn_ > 0)
+                PrintChurnStats();
+        }
+    }
+
+private:
+    template<typename Event>
+    static void Deliver(const Event& ev, system::EventHandler& handler) { handler.RaiseEvent(ev); }
+
+    template<typename Event>
+    static void Deliver(const Event& ev, PostedJoystickEvents& posted) { posted.Post(ev); }
+
+    // Turns input into the event a joystick would raise, and raises it on a device's
+    // handler or posts it to the device.
+    template<typename Target>
+    static void Send(const VirtualJoystickInput& input, Target& target) {
+        std::weak_ptr<input::Joystick> no_joystick;
+        switch (input.kind) {
+        case VirtualJoystickInput::AXIS:
+            Deliver(input::JoystickAxisEvent(no_joystick, input.index,
+                                             input::AxisStatus(static_cast<int>(input.value * 32767.0))), target);
+            break;
+        case VirtualJoystickInput::BUTTON:
+            if (input.value != 0.0)
+                Deliver(input::JoystickButtonPressedEvent(no_joystick, input.index), target);
+            else
+                Deliver(input::JoystickButtonReleasedEvent(no_joystick, input.index), target);
+            break;
+        case VirtualJoystickInput::HAT:
+            Deliver(input::JoystickHatEvent(no_joystick, input.index, input::HatStatus(HatBits(input.dx, input.dy))), target);
+            break;
+        }
+    }
+
+    std::size_t Dropped() const {
+        std::size_t dropped = 0;
+        for (const auto& posted : posted_)
+            dropped += posted->dropped();
+        return dropped;
+    }
+
+    // The SDL_HAT_* bits of a direction, which input::HatStatus is made from.
+    static int HatBits(int dx, int dy) {
+        return (dy < 0 ? 0x01 : 0) | (dx > 0 ? 0x02 : 0) | (dy > 0 ? 0x04 : 0) | (dx < 0 ? 0x08 : 0);
+    }
+
+    std::shared_ptr<JoystickDisplay> CreateDisplay(ui::Node& root, system::EventHandler& handler) {
+        char description[250];
+        snprintf(description, 250, "Virtual joystick %d -- %d Axis, %d Hat, %d Buttons",
+                 ++plugged_, num_axes_, num_hats_, num_buttons_);
+        examples::MemoryTagScope tag(examples::MemoryTag::UI);
+        auto display = examples::MakePooledShared<JoystickDisplay>(*DisplayLayout::Get(num_axes_, num_buttons_, num_hats_),
+                                                                   description, &handler);
+        root.AddChild(display->node());
+        AddDisplay(display);
+        return display;
+    }
+
+    // Replaces the churn_ least recently plugged devices with new ones.
+    void Churn() {
+        Clock::time_point begin = Clock::now();
+        for (int i = 0; i < churn_; ++i) {
+            // The display removes itself on the event. The handler is replaced after
+            // the event, since a disconnected device's handler is never raised again.
+            handlers_[next_churn_]->RaiseEvent(input::JoystickDisconnectedEvent(std::weak_ptr<input::Joystick>()));
+            handlers_[next_churn_].reset(new system::EventHandler);
+            devices_[next_churn_] = CreateDisplay(*root_, *handlers_[next_churn_]);
+            next_churn_ = (next_churn_ + 1) % num_devices_;
+        }
+        churn_time_ += examples::Milliseconds(begin, Clock::now());
+    }
+
+    void PrintChurnStats() {
+        examples::AllocationStats now = examples::CurrentAllocationStats();
+        examples::AllocationStats frame = now - allocations_;
+        allocations_ = now;
+        examples::HeapStats heap = examples::CurrentHeapStats();
+        const examples::PoolResource* pool = examples::CurrentPoolResource();
+        printf("  churn %d/frame: %.3f ms/frame, %.1f allocations/frame, %.1f KiB/frame, %.3f ms/frame in operator new/delete, "
+               "heap %lu KiB free of %lu KiB",
+               churn_, churn_time_ / 120, double(frame.allocations) / 120, frame.bytes / 1024.0 / 120,
+               frame.nanoseconds * 1e-6 / 120,
+               static_cast<unsigned long>(heap.free() / 1024), static_cast<unsigned long>(heap.reserved / 1024));
+        if (pool)
+            printf(", pool %lu KiB free of %lu KiB",
+                   static_cast<unsigned long>((pool->reserved_bytes() - pool->used_bytes()) / 1024),
+                   static_cast<unsigned long>(pool->reserved_bytes() / 1024));
+        printf("\n");
+        churn_time_ = 0.0;
+    }
+
+    VirtualJoystickInput Generate(std::minstd_rand& random, int device) const {
+        VirtualJoystickInput input = VirtualJoystickInput();
+        input.device = device;
+        const int counts[] = { num_axes_, num_buttons_, num_hats_ };
+        int kind = random() % 3;
+        while (counts[kind] == 0)
+            kind = (kind + 1) % 3;
+        input.kind = static_cast<VirtualJoystickInput::Kind>(kind);
+        input.index = random() % counts[kind];
+        if (input.kind == VirtualJoystickInput::AXIS) {
+            input.value = std::uniform_real_distribution<double>(-1.0, 1.0)(random);
+        } else if (input.kind == VirtualJoystickInput::BUTTON) {
+            input.value = random() % 2;
+        } else {
+            input.dx = static_cast<int>(random() % 3) - 1;
+            input.dy = static_cast<int>(random() % 3) - 1;
+        }
+        return input;
+    }
+
+    int num_devices_;
+    int num_axes_, num_buttons_, num_hats_;
+    int events_per_frame_;
+    int num_threads_;
+    int churn_, next_churn_;
+    int plugged_;
+    ui::Node* root_;
+    examples::AllocationStats allocations_;
+    double churn_time_ = 0.0;
+    std::minstd_rand random_;
+    std::vector<std::weak_ptr<JoystickDisplay>> devices_;
+    std::vector<std::unique_ptr<system::EventHandler>> handlers_;
+    // Only with --virtual-threads.
+    std::vector<std::unique_ptr<PostedJoystickEvents>> posted_;
+    std::atomic<bool> running_;
+    std::vector<std::thread> threads_;
+    unsigned frames_;
+    unsigned long long events_;
+    double handler_time_, frame_time_;
+    Clock::time_point last_frame_;
+};
+
 int main(int argc, char *argv[]) {
+    examples::StartupTimer startup;
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+    examples::InputRecordingOptions input_options = examples::ParseInputRecordingOptions(argc, argv);
+    examples::InputRecorder recorder(input_options.record_path);
+    examples::InputReplay replay(input_options.replay_path);
+    // --pooled allocates the displays, their nodes and drawables from a pool that
+    // lives as long as the scene. Declared before the driver, whose churned
+    // displays may come from it.
+    examples::PoolResource pool;
+    VirtualJoystickDriver driver(argc, argv);
+    ValueReport values(!driver.churning());
+    examples::MemoryOverlayOptions memory_options = examples::ParseMemoryOverlayOptions(argc, argv);
+
+    // --no-culling draws the displays that are scrolled out of view too.
+    bool culling = true;
+    // --glyph-cache=DIR keeps the rasterized glyphs of the display text in DIR, so
+    // later runs map them instead of rasterizing the font again.
+    std::unique_ptr<examples::GlyphCache> glyph_cache;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pooled") == 0)
+            examples::CurrentPoolResource() = &pool;
+        else if (std::strcmp(argv[i], "--no-culling") == 0)
+            culling = false;
+        else if (std::strcmp(argv[i], "--show-values") == 0)
+            show_values = true;
+        else if (std::strncmp(argv[i], "--glyph-cache=", 14) == 0)
+            glyph_cache.reset(new examples::GlyphCache(argv[i] + 14));
+    }
+
     system::Configuration config;
     config.canvas_size = canvas_size;
     config.windows_list[0].size = canvas_size;
     // EXAMPLE_LOCATION is defined by CMake to be the full path to the directory
     // that contains the source code for this example
     config.base_path = EXAMPLE_LOCATION "/content/";
+    bench.Configure(config);
     system::Initialize(config);
 
-    default_font = text::manager()->AddFont("default", "DejaVuSansMono.ttf", 16);
+    examples::AssetLoader loader(config.base_path, examples::ParseLoadingOptions(argc, argv));
+    auto font = loader.LoadFont("default", "DejaVuSansMono.ttf", 16);
+    // The text of the displays, rasterized on the loader's threads.
+    auto text_font_future = examples::LoadAtlasFont(loader, "DejaVuSansMono.ttf", 16, examples::AsciiCodepoints(),
+                                                    glyph_cache.get());
+    // The axis values, smaller so five characters fit under a slider.
+    std::shared_future<std::shared_ptr<examples::AtlasFont>> value_font_future;
+    if (show_values) {
+        std::string charset = std::string(examples::NUMBER_LABEL_CHARSET) + "%";
+        value_font_future = examples::LoadAtlasFont(loader, "DejaVuSansMono.ttf", 12,
+                                                    examples::CodepointsOf(charset.data(), charset.size()));
+    }
+
+    examples::PushLoadingScene(loader, [&] {
+        // Everything not tagged more precisely below belongs to the scene.
+        examples::MemoryTagScope tag(examples::MemoryTag::ACTION);
+        default_font = font.get();
+        examples::Profiler::instance().set_font(default_font);
+
+        auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+        bench.Attach(*scene);
+        // With --show-values, each frame's allocations are counted from here to the
+        // end of the render function.
+        if (show_values)
+            scene->AddTask([&values](double) {
+                values.BeginFrame();
+            });
+        recorder.Attach(*scene);
 
-    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
-    {
         // Create a node and use it as the render function of the scene.
         // Note that we purposedly bind the shared_ptr to the render function, so it's deleted along the scene.
         auto root_node = std::make_shared<ui::Node>();        
-        scene->set_render_function(std::bind(&ui::Node::Render, root_node, std::placeholders::_1));
+        auto report = std::make_shared<RenderReport>();
+        std::shared_ptr<examples::MemoryOverlay> memory_overlay;
+        if (memory_options.overlay)
+            memory_overlay = std::make_shared<examples::MemoryOverlay>(default_font);
+
+        // The text of the displays is drawn from a glyph atlas of the same font in a single
+        // batch, and the axis values from an atlas of their own, kept in value_labels.
+        // They go with the render function and the displays, so before the graphic
+        // module. Without an atlas, its text isn't shown. The futures are dropped so the
+        // render function holds the only references.
+        std::shared_ptr<examples::AtlasFont> text_font = text_font_future.get();
+        text_font_future = std::shared_future<std::shared_ptr<examples::AtlasFont>>();
+        if (value_font_future.valid()) {
+            std::shared_ptr<examples::AtlasFont> value_font = value_font_future.get();
+            value_font_future = std::shared_future<std::shared_ptr<examples::AtlasFont>>();
+            examples::MemoryTagScope text_tag(examples::MemoryTag::TEXT);
+            if (value_font)
+                value_labels = std::make_shared<examples::LabelBuffer>(value_font, AxisSlider::value_capacity(),
+                                                                       Color(1.0, 1.0, 1.0), math::Vector2D(0.5, 0.0));
+        }
+        std::shared_ptr<examples::LabelBuffer> labels = value_labels;
+        if (glyph_cache)
+            printf("Glyph cache: %s\n", glyph_cache->hits() > 0 ? "hit" : "miss");
+        auto text_batch = std::make_shared<examples::QuadBatch>();
+        scene->set_render_function(bench.Render(startup.FirstFrame([root_node, report, culling, memory_overlay, text_font, text_batch, labels, &values](graphic::Canvas& canvas) {
+            examples::MemoryTagScope tag(examples::MemoryTag::GRAPHIC);
+            auto begin = std::chrono::steady_clock::now();
+            ScrollBy(0.0, canvas.size().y);
+            root_node->geometry().set_offset(math::Vector2D(0.0, -scroll));
+            CullStats stats = CullStats();
+            if (culling)
+                stats = CullDisplays(scroll, scroll + canvas.size().y);
+            root_node->Render(canvas);
+            text_batch->Clear();
+            if (text_font)
+                for (const auto& display : active_joystick_listeners)
+                    if (display->node()->active())
+                        display->AddText(*text_batch, *text_font, root_node->geometry().offset() + display->node()->geometry().offset());
+            text_batch->Draw(canvas);
+            stats.glyphs = text_batch->size();
+            stats.text_draw_calls = text_batch->draw_calls();
+            // The values are placed in the root node's space, like the displays. Only
+            // the glyphs that changed since the last frame are written.
+            if (labels) {
+                canvas.PushAndCompose(graphic::Geometry(root_node->geometry().offset()));
+                labels->Draw(canvas);
+                canvas.PopGeometry();
+                stats.glyphs += labels->num_glyphs();
+                stats.text_draw_calls += labels->draw_calls();
+            }
+            report->EndFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count(),
+                             culling, stats);
+            // Before the memory overlay, which rebuilds its labels twice a second.
+            if (show_values)
+                values.EndFrame(labels.get());
+            if (memory_overlay)
+                memory_overlay->Draw(canvas);
+        })));
+        scene->event_handler().AddListener(ScrollOnWheel);
+        scene->event_handler().AddListener(ScrollOnKeys);
 
         // Create a weak reference to the root node so we don't delete it at the wrong time.
         std::weak_ptr<ui::Node> root_weak = root_node;
@@ -286,19 +1058,73 @@ int main(int argc, char *argv[]) {
         // Even joysticks "already connected" when our application starts goes through the joystick connection logic.
         scene->event_handler().AddListener<ugdk::input::JoystickConnectedEvent>([root_weak](const ugdk::input::JoystickConnectedEvent& ev) {
             // Create the logic object that will listen to joystick events.
-            auto rect = std::make_shared<JoystickDisplay>(ev.joystick.lock());
+            examples::MemoryTagScope tag(examples::MemoryTag::UI);
+            auto rect = examples::MakePooledShared<JoystickDisplay>(ev.joystick.lock());
             root_weak.lock()->AddChild(rect->node());
-            active_joystick_listeners.push_back(rect);
-            RepositionDisplays();
+            AddDisplay(rect);
+        });
+
+        // Replayed joysticks are shown with displays that aren't attached to any device.
+        auto replayed_displays = std::make_shared<std::vector<std::weak_ptr<JoystickDisplay>>>();
+        replay.Attach(*scene, [root_weak, replayed_displays](const examples::InputRecord& record) {
+            if (record.type == examples::InputRecord::JOYSTICK_CONNECTED) {
+                char description[250];
+                snprintf(description, 250, "Replayed joystick %d -- %d Axis, %d Hat, %d Buttons",
+                         record.device, record.a, record.c, record.b);
+                examples::MemoryTagScope tag(examples::MemoryTag::UI);
+                auto display = examples::MakePooledShared<JoystickDisplay>(*DisplayLayout::Get(record.a, record.b, record.c), description);
+                root_weak.lock()->AddChild(display->node());
+                AddDisplay(display);
+                replayed_displays->resize(std::max<std::size_t>(replayed_displays->size(), record.device + 1));
+                (*replayed_displays)[record.device] = display;
+                return;
+            }
+            auto display = record.device < replayed_displays->size() ? (*replayed_displays)[record.device].lock() : nullptr;
+            if (!display)
+                return;
+            switch (record.type) {
+            case examples::InputRecord::JOYSTICK_AXIS:
+                display->SetAxis(record.a, record.b / 32767.0);
+                break;
+            case examples::InputRecord::JOYSTICK_BUTTON_PRESSED:
+            case examples::InputRecord::JOYSTICK_BUTTON_RELEASED:
+                display->SetButton(record.a, record.type == examples::InputRecord::JOYSTICK_BUTTON_PRESSED);
+                break;
+            case examples::InputRecord::JOYSTICK_HAT:
+                display->SetHat(record.a, record.b, record.c);
+                break;
+            case examples::InputRecord::JOYSTICK_DISCONNECTED:
+                RemoveDisplay(display.get());
+                break;
+            }
         });
 
+        if (driver.enabled()) {
+            driver.PlugAll(*root_node);
+            scene->AddTask(bench.Task([&driver](double) {
+                driver.Update();
+            }, "virtual joysticks"));
+        }
+
+        // After the driver, so the numbers show this frame's input.
+        if (show_values) {
+            scene->AddTask(bench.Task([&values](double) {
+                values.Refresh();
+            }, "axis values"));
+        }
+
         // Clean yourself:
         // Remove the objects listeners when the scene finishes.
         scene->event_handler().AddListener(ClearJoystickListeners);
-    }
-    system::PushScene(std::move(scene));
+        return scene;
+    });
 
     system::Run();    
+    // The profiler's HUD labels use the default font.
+    examples::Profiler::instance().Shutdown();
     system::Release();
-    return 0;
+    if (memory_options.report_at_exit)
+        examples::PrintMemoryReport(stdout);
+    // With --show-values, a frame that allocated after warm-up fails the run.
+    return values.failed() ? 1 : 0;
 }
\ No newline at end of file
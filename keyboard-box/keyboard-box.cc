@@ -10,6 +10,10 @@
 #include <ugdk/system/compatibility.h>
 #include <ugdk/ui/drawable/texturedrectangle.h>
 
+#include <examples/benchmark.h>
+#include <examples/fixedstep.h>
+#include <examples/inputrecord.h>
+
 using namespace ugdk;
 
 namespace {
@@ -23,20 +27,22 @@ void QuitOnEscape(const ugdk::input::KeyPressedEvent& ev) {
 
 class Rectangle {
   public:
-    Rectangle() 
-      : velocity_(500.0)
+    // While replay is replaying, the keyboard state comes from it.
+    explicit Rectangle(const examples::InputReplay* replay)
+      : replay_(replay)
+      , velocity_(500.0)
       , drawable_(new ui::TexturedRectangle(graphic::manager()->white_texture(), math::Vector2D(RECTANGLE_SIZE, RECTANGLE_SIZE)))
     {}
 
     void Update(double dt) {
-        auto manager = input::manager();
-        if(manager->keyboard().IsDown(input::Scancode::A))
+        previous_position_ = position_;
+        if(examples::IsKeyDown(replay_, input::Scancode::A))
             MoveLeft(dt);
-        if(manager->keyboard().IsDown(input::Scancode::D))
+        if(examples::IsKeyDown(replay_, input::Scancode::D))
             MoveRight(dt);
-        if(manager->keyboard().IsDown(input::Scancode::W))
+        if(examples::IsKeyDown(replay_, input::Scancode::W))
             MoveUp(dt);
-        if(manager->keyboard().IsDown(input::Scancode::S))
+        if(examples::IsKeyDown(replay_, input::Scancode::S))
             MoveDown(dt);
     }
     
@@ -53,32 +59,46 @@ class Rectangle {
         position_.y += dt*velocity_;
     }
 
-    void Render(graphic::Canvas& canvas) const {
-        canvas.PushAndCompose(graphic::Geometry(position_));
+    // alpha is how far between the previous and the current update to draw the rectangle.
+    void Render(graphic::Canvas& canvas, double alpha) const {
+        canvas.PushAndCompose(graphic::Geometry(previous_position_ + (position_ - previous_position_) * alpha));
         drawable_->Draw(canvas);
         canvas.PopGeometry();
     }
 
   private:
+    const examples::InputReplay* replay_;
     double velocity_;
-    math::Vector2D position_;
+    math::Vector2D position_, previous_position_;
     std::unique_ptr<ui::TexturedRectangle> drawable_;
 };
 
 int main(int argc, char* argv[]) {
-    system::Initialize();
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+    examples::FixedStep fixed_step(examples::ParseFixedStepOptions(argc, argv));
+    examples::InputRecordingOptions input_options = examples::ParseInputRecordingOptions(argc, argv);
+    examples::InputRecorder recorder(input_options.record_path);
+    examples::InputReplay replay(input_options.replay_path);
+
+    system::Configuration config;
+    bench.Configure(config);
+    system::Initialize(config);
 
     auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    recorder.Attach(*scene);
+    replay.Attach(*scene);
     scene->event_handler().AddListener(QuitOnEscape);
 
     {
-        auto r = std::make_shared<Rectangle>();
-        scene->AddTask([r](double dt) {
+        auto r = std::make_shared<Rectangle>(&replay);
+        scene->AddTask(bench.Task(fixed_step.Task([r](double dt) {
             r->Update(dt);
-        });
-        scene->set_render_function([r](graphic::Canvas& canvas) {
-            r->Render(canvas);
-        });
+        })));
+        examples::FixedStep* step = &fixed_step;
+        scene->set_render_function(bench.Render(step->Render([r, step](graphic::Canvas& canvas) {
+            r->Render(canvas, step->alpha());
+        })));
     }
     system::PushScene(std::move(scene));
 
@@ -0,0 +1,175 @@
+#include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
+#include <ugdk/system/compatibility.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/input/events.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/text/module.h>
+#include <ugdk/text/label.h>
+#include <ugdk/ui/node.h>
+
+#include <examples/atlastext.h>
+#include <examples/benchmark.h>
+#include <examples/labelcache.h>
+#include <examples/mappedfile.h>
+#include <examples/processmemory.h>
+#include <examples/profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace ugdk;
+
+// Creates many small labels with the strings joystick-display uses and reports the
+// memory they take and how long they take to render: one text::Label per node,
+// interned labels shared between nodes, or every string queued from a glyph atlas
+// into a single examples::QuadBatch.
+//
+// Usage: example-label-stress [COUNT] [--no-interning | --batched]
+
+namespace {
+    const math::Vector2D canvas_size(1280.0, 720.0);
+    const std::size_t default_label_count = 10000;
+
+    void QuitOnEscape(const input::KeyPressedEvent& ev) {
+        if (ev.scancode == input::Scancode::ESCAPE)
+            system::CurrentScene().Finish();
+    }
+
+    std::vector<std::string> LabelStrings() {
+        std::vector<std::string> strings = { "Axis", "Buttons", "Hats" };
+        for (int i = 0; i < 32; ++i)
+            strings.push_back(std::to_string(i));
+        return strings;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+
+    std::size_t label_count = default_label_count;
+    bool interning = true, batched = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-interning") == 0)
+            interning = false;
+        else if (std::strcmp(argv[i], "--batched") == 0)
+            batched = true;
+        else if (!examples::IsBenchmarkOption(argv[i]))
+            label_count = std::max(1, std::atoi(argv[i]));
+    }
+
+    system::Configuration config;
+    config.canvas_size = canvas_size;
+    config.windows_list[0].size = canvas_size;
+    // EXAMPLE_LOCATION is defined by CMake to be the full path to the directory
+    // that contains the source code for this example
+    config.base_path = EXAMPLE_LOCATION "/../joystick-display/content/";
+    bench.Configure(config);
+    system::Initialize(config);
+
+    text::Font* font = text::manager()->AddFont("default", "DejaVuSansMono.ttf", 16);
+    examples::Profiler::instance().set_font(font);
+
+    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    scene->event_handler().AddListener(QuitOnEscape);
+    if (batched) {
+        // The atlas and the batch are owned by the render function, so its texture and
+        // vertex buffer are released along with the scene.
+        std::vector<std::string> strings = LabelStrings();
+        std::size_t memory_before = examples::ResidentSetSize();
+        auto creation_begin = std::chrono::steady_clock::now();
+        examples::MappedFile font_file(config.base_path + "DejaVuSansMono.ttf");
+        std::unique_ptr<examples::GlyphAtlas> atlas;
+        if (font_file.is_open())
+            atlas = examples::GlyphCache::Rasterize(font_file, 16, examples::AsciiCodepoints());
+        if (!atlas) {
+            fprintf(stderr, "Unable to rasterize DejaVuSansMono.ttf.\n");
+            examples::Profiler::instance().Shutdown();
+            system::Release();
+            return 1;
+        }
+        auto atlas_font = std::make_shared<examples::AtlasFont>(std::move(atlas));
+        auto batch = std::make_shared<examples::QuadBatch>();
+        auto positions = std::make_shared<std::vector<math::Vector2D>>();
+        const int columns = 100;
+        for (std::size_t i = 0; i < label_count; ++i)
+            positions->push_back(math::Vector2D((i % columns) * canvas_size.x / columns,
+                                                (i / columns % 40) * canvas_size.y / 40));
+        double creation_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - creation_begin).count();
+        std::size_t memory_after = examples::ResidentSetSize();
+
+        printf("%u labels (batched): 1 glyph atlas, created in %.2f ms, %ld KiB resident memory\n",
+               static_cast<unsigned>(label_count), creation_ms,
+               (static_cast<long>(memory_after) - static_cast<long>(memory_before)) / 1024);
+
+        auto render_time = std::make_shared<double>(0.0);
+        auto frames = std::make_shared<unsigned>(0);
+        scene->set_render_function(bench.Render([atlas_font, batch, positions, strings, render_time, frames](graphic::Canvas& canvas) {
+            auto begin = std::chrono::steady_clock::now();
+            batch->Clear();
+            for (std::size_t i = 0; i < positions->size(); ++i)
+                atlas_font->AddText(*batch, strings[i % strings.size()], (*positions)[i], Color(1.0, 1.0, 1.0));
+            batch->Draw(canvas);
+            *render_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            if (++*frames % 120 == 0) {
+                printf("render: %.3f ms/frame, %u glyphs in %u draw calls\n", *render_time / 120,
+                       static_cast<unsigned>(batch->size()), static_cast<unsigned>(batch->draw_calls()));
+                *render_time = 0.0;
+            }
+        }));
+    } else {
+        // Both the cache and the nodes are owned by the render function, so the labels
+        // are released along with the scene.
+        auto cache = std::make_shared<examples::LabelCache>();
+        auto root_node = std::make_shared<ui::Node>();
+        std::vector<std::string> strings = LabelStrings();
+
+        std::size_t memory_before = examples::ResidentSetSize();
+        auto creation_begin = std::chrono::steady_clock::now();
+        const int columns = 100;
+        for (std::size_t i = 0; i < label_count; ++i) {
+            const std::string& str = strings[i % strings.size()];
+            std::shared_ptr<ui::Node> node;
+            if (interning)
+                node = std::make_shared<ui::Node>(cache->MakeDrawable(str, font));
+            else
+                node = std::make_shared<ui::Node>(MakeUnique<text::Label>(str, font));
+            node->geometry().set_offset(math::Vector2D((i % columns) * canvas_size.x / columns,
+                                                       (i / columns % 40) * canvas_size.y / 40));
+            root_node->AddChild(node);
+        }
+        double creation_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - creation_begin).count();
+        std::size_t memory_after = examples::ResidentSetSize();
+
+        printf("%u labels (%s): %u label objects, created in %.2f ms, %ld KiB resident memory\n",
+               static_cast<unsigned>(label_count), interning ? "interned" : "one per node",
+               static_cast<unsigned>(interning ? cache->size() : label_count), creation_ms,
+               (static_cast<long>(memory_after) - static_cast<long>(memory_before)) / 1024);
+
+        auto render_time = std::make_shared<double>(0.0);
+        auto frames = std::make_shared<unsigned>(0);
+        scene->set_render_function(bench.Render([root_node, cache, render_time, frames](graphic::Canvas& canvas) {
+            auto begin = std::chrono::steady_clock::now();
+            root_node->Render(canvas);
+            *render_time += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            if (++*frames % 120 == 0) {
+                printf("render: %.3f ms/frame\n", *render_time / 120);
+                *render_time = 0.0;
+            }
+        }));
+    }
+    system::PushScene(std::move(scene));
+
+    system::Run();
+    // The profiler's HUD labels use the default font.
+    examples::Profiler::instance().Shutdown();
+    system::Release();
+    return 0;
+}
@@ -0,0 +1,160 @@
+#include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/input/events.h>
+#include <ugdk/desktop/window.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/module.h>
+#include <ugdk/graphic/visualeffect.h>
+#include <ugdk/system/compatibility.h>
+#include <ugdk/ui/drawable/texturedrectangle.h>
+
+#include <examples/benchmark.h>
+#include <examples/quadbatch.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ugdk;
+
+namespace {
+    const math::Vector2D canvas_size(1280.0, 720.0);
+    const math::Vector2D box_size(8.0, 8.0);
+    const std::size_t default_box_count = 10000;
+
+    const Color palette[] = {
+        Color(1.0, 0.3, 0.3), Color(0.3, 1.0, 0.3), Color(0.3, 0.3, 1.0), Color(1.0, 1.0, 0.3),
+        Color(1.0, 0.3, 1.0), Color(0.3, 1.0, 1.0), Color(1.0, 0.6, 0.2), Color(0.8, 0.8, 0.8),
+    };
+    const std::size_t palette_size = sizeof(palette) / sizeof(palette[0]);
+
+    struct Box {
+        math::Vector2D offset;
+        std::size_t color;
+    };
+
+    void QuitOnEscape(const input::KeyPressedEvent& ev) {
+        if (ev.scancode == input::Scancode::ESCAPE)
+            system::CurrentScene().Finish();
+    }
+}
+
+// Accumulates frame times and draw calls, printing an average once per second.
+class FrameReport {
+  public:
+    FrameReport()
+        : frames_(0)
+        , draw_calls_(0)
+        , frame_time_(0.0)
+        , last_frame_(std::chrono::steady_clock::now())
+        , last_report_(last_frame_)
+    {}
+
+    void EndFrame(std::size_t draw_calls, bool batched) {
+        auto now = std::chrono::steady_clock::now();
+        frame_time_ += std::chrono::duration<double, std::milli>(now - last_frame_).count();
+        draw_calls_ += draw_calls;
+        frames_ += 1;
+        last_frame_ = now;
+
+        if (now - last_report_ >= std::chrono::seconds(1)) {
+            printf("[%s] %u frames, %.3f ms/frame, %.1f draw calls/frame\n",
+                   batched ? "batched" : "per-box",
+                   frames_, frame_time_ / frames_, double(draw_calls_) / frames_);
+            frames_ = 0;
+            draw_calls_ = 0;
+            frame_time_ = 0.0;
+            last_report_ = now;
+        }
+    }
+
+  private:
+    unsigned frames_;
+    std::size_t draw_calls_;
+    double frame_time_;
+    std::chrono::steady_clock::time_point last_frame_, last_report_;
+};
+
+int main(int argc, char *argv[]) {
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+
+    std::size_t box_count = default_box_count;
+    for (int i = 1; i < argc; ++i)
+        if (!examples::IsBenchmarkOption(argv[i]))
+            box_count = std::max(1, std::atoi(argv[i]));
+
+    system::Configuration config;
+    config.canvas_size = canvas_size;
+    config.windows_list[0].size = canvas_size;
+    bench.Configure(config);
+    system::Initialize(config);
+
+    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    scene->event_handler().AddListener(QuitOnEscape);
+    {
+        // Colors are carried per vertex, so boxes of every color share one draw call.
+        std::default_random_engine engine(42);
+        std::normal_distribution<double> spread(0.0, 0.15);
+        std::uniform_int_distribution<std::size_t> color_dist(0, palette_size - 1);
+        auto boxes = std::make_shared<std::vector<Box>>(box_count);
+        for (Box& box : *boxes) {
+            box.offset = math::Vector2D(spread(engine), spread(engine)).Scale(canvas_size);
+            box.color = color_dist(engine);
+        }
+
+        auto rect = std::make_shared<ui::TexturedRectangle>(graphic::manager()->white_texture(), box_size);
+        rect->set_hotspot(ui::HookPoint::CENTER);
+        auto batch = std::make_shared<examples::QuadBatch>(box_count);
+        auto report = std::make_shared<FrameReport>();
+        auto batched = std::make_shared<bool>(true);
+        auto swarm_position = std::make_shared<math::Vector2D>(0.5, 0.5);
+
+        // The whole swarm follows the mouse, like the single box of draggable-box.
+        scene->event_handler().AddListener<input::MouseMotionEvent>([swarm_position](const input::MouseMotionEvent& ev) {
+            auto window = ev.window.lock();
+            swarm_position->x = double(ev.position.x) / window->size().x;
+            swarm_position->y = double(ev.position.y) / window->size().y;
+        });
+
+        // B toggles between the batched path and one TexturedRectangle::Draw per box.
+        scene->event_handler().AddListener<input::KeyPressedEvent>([batched](const input::KeyPressedEvent& ev) {
+            if (ev.scancode == input::Scancode::B)
+                *batched = !*batched;
+        });
+
+        scene->set_render_function(bench.Render([=](graphic::Canvas& canvas) {
+            math::Vector2D center = swarm_position->Scale(canvas.size());
+            std::size_t draw_calls = 0;
+            if (*batched) {
+                math::Vector2D half_size = box_size * 0.5;
+                batch->Clear();
+                for (const Box& box : *boxes)
+                    batch->Add(graphic::manager()->white_texture(), center + box.offset - half_size,
+                               box_size, palette[box.color]);
+                batch->Draw(canvas);
+                draw_calls = batch->draw_calls();
+            } else {
+                for (const Box& box : *boxes) {
+                    canvas.PushAndCompose(graphic::Geometry(center + box.offset));
+                    canvas.PushAndCompose(graphic::VisualEffect(palette[box.color]));
+                    rect->Draw(canvas);
+                    canvas.PopVisualEffect();
+                    canvas.PopGeometry();
+                }
+                draw_calls = boxes->size();
+            }
+            report->EndFrame(draw_calls, *batched);
+        }));
+    }
+    system::PushScene(std::move(scene));
+
+    system::Run();
+    system::Release();
+    return 0;
+}
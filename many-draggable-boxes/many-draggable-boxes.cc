@@ -0,0 +1,209 @@
+// Tens of thousands of boxes that can each be grabbed and dragged with the mouse.
+// The box under the cursor is highlighted, so every mouse motion is a pick.
+//
+// Picks go through examples::SpatialGrid, which only looks at the boxes of the
+// cell under the cursor. With --linear they scan every box from the top down
+// instead. Average pick times are printed once per second.
+//
+// Usage: example-many-draggable-boxes [--linear] [box count]
+
+#include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/input/events.h>
+#include <ugdk/desktop/window.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/module.h>
+#include <ugdk/system/compatibility.h>
+
+#include <examples/benchmark.h>
+#include <examples/quadbatch.h>
+#include <examples/spatialgrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ugdk;
+
+namespace {
+    const math::Vector2D canvas_size(1280.0, 720.0);
+    const math::Vector2D box_size(12.0, 12.0);
+    const std::size_t default_box_count = 50000;
+    // About the size of a box, so most boxes are listed in only a few cells.
+    const double cell_size = 16.0;
+
+    const Color box_color(0.55, 0.55, 0.6);
+    const Color hover_color(1.0, 1.0, 0.3);
+    const Color grabbed_color(1.0, 0.4, 0.3);
+
+    typedef examples::SpatialGrid::Id BoxId;
+
+    void QuitOnEscape(const input::KeyPressedEvent& ev) {
+        if (ev.scancode == input::Scancode::ESCAPE)
+            system::CurrentScene().Finish();
+    }
+}
+
+// The boxes, in canvas coordinates, and their draw order.
+class BoxField {
+  public:
+    BoxField(std::size_t count, bool linear)
+        : grid_(examples::Bounds(0.0, 0.0, canvas_size.x, canvas_size.y), cell_size)
+        , linear_(linear)
+        , next_order_(0)
+        , picks_(0)
+        , pick_time_(0.0)
+    {
+        std::default_random_engine engine(42);
+        std::uniform_real_distribution<double> x_dist(0.0, canvas_size.x), y_dist(0.0, canvas_size.y);
+        positions_.resize(count);
+        draw_order_.resize(count);
+        for (BoxId id = 0; id < count; ++id) {
+            positions_[id] = math::Vector2D(x_dist(engine), y_dist(engine));
+            draw_order_[id] = id;
+            grid_.Insert(id, BoxBounds(id), next_order_++);
+        }
+    }
+
+    // The top-most box under the point, or SpatialGrid::NONE.
+    BoxId Pick(const math::Vector2D& point) {
+        auto begin = std::chrono::steady_clock::now();
+        BoxId result = examples::SpatialGrid::NONE;
+        if (linear_) {
+            for (auto it = draw_order_.rbegin(); it != draw_order_.rend(); ++it)
+                if (BoxBounds(*it).Contains(point.x, point.y)) {
+                    result = *it;
+                    break;
+                }
+        } else {
+            result = grid_.Pick(point.x, point.y);
+        }
+        pick_time_ += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - begin).count();
+        ++picks_;
+        return result;
+    }
+
+    void BringToFront(BoxId id) {
+        draw_order_.erase(std::find(draw_order_.begin(), draw_order_.end(), id));
+        draw_order_.push_back(id);
+        grid_.set_order(id, next_order_++);
+    }
+
+    void Move(BoxId id, const math::Vector2D& position) {
+        positions_[id] = position;
+        grid_.Move(id, BoxBounds(id));
+    }
+
+    const math::Vector2D& position(BoxId id) const { return positions_[id]; }
+    const std::vector<BoxId>& draw_order() const { return draw_order_; }
+
+    void PrintPickStats() {
+        if (picks_ == 0)
+            return;
+        printf("[%s] %u picks, %.3f us/pick\n", linear_ ? "linear" : "grid", picks_, pick_time_ / picks_);
+        picks_ = 0;
+        pick_time_ = 0.0;
+    }
+
+  private:
+    examples::Bounds BoxBounds(BoxId id) const {
+        return examples::Bounds::Centered(positions_[id].x, positions_[id].y, box_size.x, box_size.y);
+    }
+
+    std::vector<math::Vector2D> positions_;
+    std::vector<BoxId> draw_order_;
+    examples::SpatialGrid grid_;
+    bool linear_;
+    unsigned next_order_;
+    unsigned picks_;
+    double pick_time_;
+};
+
+int main(int argc, char *argv[]) {
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+
+    std::size_t box_count = default_box_count;
+    bool linear = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--linear") == 0)
+            linear = true;
+        else if (!examples::IsBenchmarkOption(argv[i]))
+            box_count = std::max(1, std::atoi(argv[i]));
+    }
+
+    system::Configuration config;
+    config.canvas_size = canvas_size;
+    config.windows_list[0].size = canvas_size;
+    bench.Configure(config);
+    system::Initialize(config);
+
+    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    scene->event_handler().AddListener(QuitOnEscape);
+    {
+        auto field = std::make_shared<BoxField>(box_count, linear);
+        auto batch = std::make_shared<examples::QuadBatch>(box_count);
+        auto hovered = std::make_shared<BoxId>(examples::SpatialGrid::NONE);
+        auto grabbed = std::make_shared<BoxId>(examples::SpatialGrid::NONE);
+        // Where the box was grabbed, relative to its center.
+        auto grab_offset = std::make_shared<math::Vector2D>();
+        auto cursor = std::make_shared<math::Vector2D>();
+
+        scene->event_handler().AddListener<input::MouseMotionEvent>([=](const input::MouseMotionEvent& ev) {
+            auto window = ev.window.lock();
+            *cursor = math::Vector2D(double(ev.position.x) / window->size().x,
+                                     double(ev.position.y) / window->size().y).Scale(canvas_size);
+            if (*grabbed != examples::SpatialGrid::NONE)
+                field->Move(*grabbed, *cursor + *grab_offset);
+            else
+                *hovered = field->Pick(*cursor);
+        });
+        scene->event_handler().AddListener<input::MouseButtonPressedEvent>([=](const input::MouseButtonPressedEvent& ev) {
+            if (ev.button != input::MouseButton::LEFT)
+                return;
+            *grabbed = field->Pick(*cursor);
+            if (*grabbed == examples::SpatialGrid::NONE)
+                return;
+            *grab_offset = field->position(*grabbed) - *cursor;
+            field->BringToFront(*grabbed);
+        });
+        scene->event_handler().AddListener<input::MouseButtonReleasedEvent>([=](const input::MouseButtonReleasedEvent& ev) {
+            if (ev.button != input::MouseButton::LEFT)
+                return;
+            *grabbed = examples::SpatialGrid::NONE;
+            *hovered = field->Pick(*cursor);
+        });
+
+        auto last_report = std::make_shared<std::chrono::steady_clock::time_point>(std::chrono::steady_clock::now());
+        scene->set_render_function(bench.Render([=](graphic::Canvas& canvas) {
+            // The highlighted box is drawn last, on top, so every other box shares one run.
+            BoxId highlighted = *grabbed != examples::SpatialGrid::NONE ? *grabbed : *hovered;
+            math::Vector2D half_size = box_size * 0.5;
+            batch->Clear();
+            for (BoxId id : field->draw_order())
+                if (id != highlighted)
+                    batch->Add(graphic::manager()->white_texture(), field->position(id) - half_size, box_size, box_color);
+            if (highlighted != examples::SpatialGrid::NONE)
+                batch->Add(graphic::manager()->white_texture(), field->position(highlighted) - half_size, box_size,
+                           highlighted == *grabbed ? grabbed_color : hover_color);
+            batch->Draw(canvas);
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - *last_report >= std::chrono::seconds(1)) {
+                field->PrintPickStats();
+                *last_report = now;
+            }
+        }));
+    }
+    system::PushScene(std::move(scene));
+
+    system::Run();
+    system::Release();
+    return 0;
+}
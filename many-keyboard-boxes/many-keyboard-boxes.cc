@@ -0,0 +1,381 @@
+#include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/input/module.h>
+#include <ugdk/input/events.h>
+#include <ugdk/input/scancode.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/graphic/module.h>
+#include <ugdk/graphic/visualeffect.h>
+#include <ugdk/system/compatibility.h>
+#include <ugdk/ui/drawable/texturedrectangle.h>
+
+#include <examples/benchmark.h>
+#include <examples/clock.h>
+#include <examples/framepipeline.h>
+#include <examples/inputrecord.h>
+#include <examples/paralleltasks.h>
+#include <examples/quadbatch.h>
+#include <examples/workstealingpool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace ugdk;
+
+// keyboard-box with 100k boxes: every box moves with WASD at its own speed.
+//
+// Usage: example-many-keyboard-boxes [COUNT] [--per-object] [--threads=N] [--pipelined]
+// The boxes are kept as a structure of arrays and updated by a single loop, with
+// the keyboard read once per frame. --per-object uses one object per box instead,
+// each reading the keyboard and drawing itself like keyboard-box's Rectangle.
+// --threads splits the update loop in chunks run by a examples::ParallelTaskGroup.
+// --pipelined runs the update of the next frame on a examples::FramePipeline while
+// the current frame is drawn, which shows the keyboard one frame later.
+
+namespace {
+    const math::Vector2D canvas_size(1280.0, 720.0);
+    const math::Vector2D box_size(4.0, 4.0);
+    const std::size_t default_box_count = 100000;
+    const std::size_t boxes_per_chunk = 16384;
+
+    const Color palette[] = {
+        Color(1.0, 0.3, 0.3), Color(0.3, 1.0, 0.3), Color(0.3, 0.3, 1.0), Color(1.0, 1.0, 0.3),
+    };
+    const std::size_t palette_size = sizeof(palette) / sizeof(palette[0]);
+
+    // -1, 0 or 1, as negative or positive is held, in replay while it's replaying.
+    float KeyAxis(const examples::InputReplay* replay, input::Scancode negative, input::Scancode positive) {
+        return static_cast<float>(examples::IsKeyDown(replay, positive))
+             - static_cast<float>(examples::IsKeyDown(replay, negative));
+    }
+
+    void QuitOnEscape(const input::KeyPressedEvent& ev) {
+        if (ev.scancode == input::Scancode::ESCAPE)
+            system::CurrentScene().Finish();
+    }
+
+    typedef std::chrono::steady_clock Clock;
+}
+
+// Positions, speeds and colors of every box, one array each. Boxes are sorted by
+// color, so color_begin[c] .. color_begin[c + 1] are the boxes drawn with palette[c].
+struct BoxStore {
+    std::vector<float> x, y;
+    std::vector<float> speed;
+    std::size_t color_begin[palette_size + 1];
+
+    std::size_t size() const { return x.size(); }
+
+    void Create(std::size_t count, std::default_random_engine& engine) {
+        std::uniform_real_distribution<float> x_dist(0.0f, static_cast<float>(canvas_size.x));
+        std::uniform_real_distribution<float> y_dist(0.0f, static_cast<float>(canvas_size.y));
+        std::uniform_real_distribution<float> speed_dist(100.0f, 500.0f);
+        x.resize(count);
+        y.resize(count);
+        speed.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            x[i] = x_dist(engine);
+            y[i] = y_dist(engine);
+            speed[i] = speed_dist(engine);
+        }
+        for (std::size_t c = 0; c <= palette_size; ++c)
+            color_begin[c] = count * c / palette_size;
+    }
+};
+
+// Moves every box by its speed in the direction (dx, dy), wrapping around the canvas.
+// No branches and no aliasing, so the compiler can vectorize the loop.
+void UpdateBoxes(float* __restrict x, float* __restrict y, const float* __restrict speed, std::size_t count,
+                 float dx, float dy, float dt) {
+    const float width = static_cast<float>(canvas_size.x), height = static_cast<float>(canvas_size.y);
+    for (std::size_t i = 0; i < count; ++i) {
+        float nx = x[i] + dx * speed[i] * dt;
+        float ny = y[i] + dy * speed[i] * dt;
+        nx += width * (static_cast<float>(nx < 0.0f) - static_cast<float>(nx >= width));
+        ny += height * (static_cast<float>(ny < 0.0f) - static_cast<float>(ny >= height));
+        x[i] = nx;
+        y[i] = ny;
+    }
+}
+
+// Like UpdateBoxes, but reads the positions from (x, y) and writes them to
+// (out_x, out_y), so the old positions can be drawn while the new ones are computed.
+void MoveBoxes(const float* __restrict x, const float* __restrict y, float* __restrict out_x,
+               float* __restrict out_y, const float* __restrict speed, std::size_t count,
+               float dx, float dy, float dt) {
+    const float width = static_cast<float>(canvas_size.x), height = static_cast<float>(canvas_size.y);
+    for (std::size_t i = 0; i < count; ++i) {
+        float nx = x[i] + dx * speed[i] * dt;
+        float ny = y[i] + dy * speed[i] * dt;
+        nx += width * (static_cast<float>(nx < 0.0f) - static_cast<float>(nx >= width));
+        ny += height * (static_cast<float>(ny < 0.0f) - static_cast<float>(ny >= height));
+        out_x[i] = nx;
+        out_y[i] = ny;
+    }
+}
+
+// Runs the update in chunks on several threads. The keyboard is read by a task
+// without declared data, so it stays on the main thread and runs first.
+struct ParallelUpdate {
+    explicit ParallelUpdate(unsigned threads)
+        : pool(threads - 1)
+        , tasks(pool)
+        , dx(0.0f)
+        , dy(0.0f)
+    {}
+
+    examples::WorkStealingPool pool;
+    examples::ParallelTaskGroup tasks;
+    float dx, dy;
+};
+
+// Two copies of the positions. The pipeline's job computes back from front while
+// front is drawn; Swap, called after the job is waited for, shows the new ones.
+// Speeds and colors are never written, so both threads read them from the store.
+struct PipelinedUpdate {
+    explicit PipelinedUpdate(const BoxStore& store)
+        : back_x(store.x)
+        , back_y(store.y)
+        , update_ms(0.0)
+    {}
+
+    void Swap(BoxStore& store) {
+        store.x.swap(back_x);
+        store.y.swap(back_y);
+    }
+
+    std::vector<float> back_x, back_y;
+    // Written by the job, so only read after waiting for it.
+    double update_ms;
+    // Last, so it's destroyed first: its destructor waits for a job still writing
+    // to the members above.
+    examples::FramePipeline pipeline;
+};
+
+// The object-per-box layout this example replaces.
+class Rectangle {
+  public:
+    Rectangle(const math::Vector2D& position, double speed, std::size_t color, const examples::InputReplay* replay)
+        : replay_(replay)
+        , position_(position)
+        , velocity_(speed)
+        , color_(color)
+    {}
+
+    // Wraps around the canvas like UpdateBoxes, so both do the same work.
+    void Update(double dt) {
+        if (examples::IsKeyDown(replay_, input::Scancode::A))
+            position_.x -= dt * velocity_;
+        if (examples::IsKeyDown(replay_, input::Scancode::D))
+            position_.x += dt * velocity_;
+        if (examples::IsKeyDown(replay_, input::Scancode::W))
+            position_.y -= dt * velocity_;
+        if (examples::IsKeyDown(replay_, input::Scancode::S))
+            position_.y += dt * velocity_;
+        if (position_.x < 0.0)
+            position_.x += canvas_size.x;
+        else if (position_.x >= canvas_size.x)
+            position_.x -= canvas_size.x;
+        if (position_.y < 0.0)
+            position_.y += canvas_size.y;
+        else if (position_.y >= canvas_size.y)
+            position_.y -= canvas_size.y;
+    }
+
+    void Render(graphic::Canvas& canvas, const ui::TexturedRectangle& drawable) const {
+        canvas.PushAndCompose(graphic::Geometry(position_));
+        canvas.PushAndCompose(graphic::VisualEffect(palette[color_]));
+        drawable.Draw(canvas);
+        canvas.PopVisualEffect();
+        canvas.PopGeometry();
+    }
+
+  private:
+    const examples::InputReplay* replay_;
+    math::Vector2D position_;
+    double velocity_;
+    std::size_t color_;
+};
+
+// Accumulates update and render times, printing an average once per second.
+class UpdateReport {
+  public:
+    UpdateReport(std::size_t count, const char* mode)
+        : count_(count)
+        , mode_(mode)
+        , frames_(0)
+        , update_ms_(0.0)
+        , wait_ms_(0.0)
+        , render_ms_(0.0)
+        , last_report_(Clock::now())
+    {}
+
+    void AddUpdate(double ms) { update_ms_ += ms; }
+    // Time the main thread spent waiting for a pipelined update.
+    void AddWait(double ms) { wait_ms_ += ms; }
+
+    void EndFrame(double render_ms) {
+        render_ms_ += render_ms;
+        frames_ += 1;
+        Clock::time_point now = Clock::now();
+        if (now - last_report_ >= std::chrono::seconds(1)) {
+            printf("[%s] %u boxes, update %.3f ms/frame (%.2f ns/box), render %.3f ms/frame",
+                   mode_, static_cast<unsigned>(count_),
+                   update_ms_ / frames_, update_ms_ * 1e6 / frames_ / count_, render_ms_ / frames_);
+            if (wait_ms_ > 0.0)
+                printf(", waited %.3f ms/frame for the update", wait_ms_ / frames_);
+            printf("\n");
+            frames_ = 0;
+            update_ms_ = wait_ms_ = render_ms_ = 0.0;
+            last_report_ = now;
+        }
+    }
+
+  private:
+    std::size_t count_;
+    const char* mode_;
+    unsigned frames_;
+    double update_ms_, wait_ms_, render_ms_;
+    Clock::time_point last_report_;
+};
+
+int main(int argc, char *argv[]) {
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+    examples::InputRecordingOptions input_options = examples::ParseInputRecordingOptions(argc, argv);
+    examples::InputRecorder recorder(input_options.record_path);
+    examples::InputReplay replay(input_options.replay_path);
+
+    std::size_t box_count = default_box_count;
+    bool per_object = false, pipelined = false;
+    unsigned threads = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--per-object") == 0)
+            per_object = true;
+        else if (std::strcmp(argv[i], "--pipelined") == 0)
+            pipelined = true;
+        else if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            threads = static_cast<unsigned>(std::max(1, std::atoi(argv[i] + 10)));
+        else if (!examples::IsBenchmarkOption(argv[i]) && !examples::IsInputRecordingOption(argv[i]))
+            box_count = std::max(1, std::atoi(argv[i]));
+    }
+
+    system::Configuration config;
+    config.canvas_size = canvas_size;
+    config.windows_list[0].size = canvas_size;
+    bench.Configure(config);
+    system::Initialize(config);
+
+    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    recorder.Attach(*scene);
+    replay.Attach(*scene);
+    scene->event_handler().AddListener(QuitOnEscape);
+    {
+        // While a recording is being replayed, the keyboard state comes from it.
+        const examples::InputReplay* input_replay = &replay;
+        std::default_random_engine engine(42);
+        auto boxes = std::make_shared<BoxStore>();
+        boxes->Create(box_count, engine);
+        const char* mode = per_object ? "per-object" : pipelined ? "arrays, pipelined" : "arrays";
+        auto report = std::make_shared<UpdateReport>(box_count, mode);
+
+        if (per_object) {
+            auto rects = std::make_shared<std::vector<Rectangle>>();
+            rects->reserve(box_count);
+            for (std::size_t c = 0; c < palette_size; ++c)
+                for (std::size_t i = boxes->color_begin[c]; i < boxes->color_begin[c + 1]; ++i)
+                    rects->emplace_back(math::Vector2D(boxes->x[i], boxes->y[i]), boxes->speed[i], c, input_replay);
+            auto drawable = std::make_shared<ui::TexturedRectangle>(graphic::manager()->white_texture(), box_size);
+
+            scene->AddTask(bench.Task([rects, report](double dt) {
+                Clock::time_point begin = Clock::now();
+                for (Rectangle& rect : *rects)
+                    rect.Update(dt);
+                report->AddUpdate(examples::Milliseconds(begin, Clock::now()));
+            }));
+            scene->set_render_function(bench.Render([rects, drawable, report](graphic::Canvas& canvas) {
+                Clock::time_point begin = Clock::now();
+                for (const Rectangle& rect : *rects)
+                    rect.Render(canvas, *drawable);
+                report->EndFrame(examples::Milliseconds(begin, Clock::now()));
+            }));
+        } else {
+            if (pipelined) {
+                // The keyboard is read here, on the main thread, and the job gets copies
+                // of everything it needs besides the store's arrays.
+                auto update = std::make_shared<PipelinedUpdate>(*boxes);
+                scene->AddTask(bench.Task([update, boxes, report, input_replay](double dt) {
+                    report->AddWait(update->pipeline.Wait());
+                    report->AddUpdate(update->update_ms);
+                    update->Swap(*boxes);
+                    float dx = KeyAxis(input_replay, input::Scancode::A, input::Scancode::D);
+                    float dy = KeyAxis(input_replay, input::Scancode::W, input::Scancode::S);
+                    PipelinedUpdate* job_update = update.get();
+                    std::shared_ptr<const BoxStore> store = boxes;
+                    update->pipeline.Start([job_update, store, dx, dy, dt] {
+                        Clock::time_point begin = Clock::now();
+                        MoveBoxes(store->x.data(), store->y.data(), job_update->back_x.data(),
+                                  job_update->back_y.data(), store->speed.data(), store->size(),
+                                  dx, dy, static_cast<float>(dt));
+                        job_update->update_ms = examples::Milliseconds(begin, Clock::now());
+                    });
+                }));
+            } else if (threads > 1) {
+                auto update = std::make_shared<ParallelUpdate>(threads);
+                ParallelUpdate* direction = update.get();
+                BoxStore* store = boxes.get();
+                direction->tasks.Add([direction, input_replay](double) {
+                    direction->dx = KeyAxis(input_replay, input::Scancode::A, input::Scancode::D);
+                    direction->dy = KeyAxis(input_replay, input::Scancode::W, input::Scancode::S);
+                });
+                for (std::size_t first = 0; first < box_count; first += boxes_per_chunk) {
+                    std::size_t count = std::min(boxes_per_chunk, box_count - first);
+                    direction->tasks.Add([store, direction, first, count](double dt) {
+                        UpdateBoxes(store->x.data() + first, store->y.data() + first, store->speed.data() + first,
+                                    count, direction->dx, direction->dy, static_cast<float>(dt));
+                    }, {direction}, {store->x.data() + first});
+                }
+                scene->AddTask(bench.Task([update, boxes, report](double dt) {
+                    Clock::time_point begin = Clock::now();
+                    update->tasks.Run(dt);
+                    report->AddUpdate(examples::Milliseconds(begin, Clock::now()));
+                }));
+            } else {
+                scene->AddTask(bench.Task([boxes, report, input_replay](double dt) {
+                    Clock::time_point begin = Clock::now();
+                    float dx = KeyAxis(input_replay, input::Scancode::A, input::Scancode::D);
+                    float dy = KeyAxis(input_replay, input::Scancode::W, input::Scancode::S);
+                    UpdateBoxes(boxes->x.data(), boxes->y.data(), boxes->speed.data(), boxes->size(),
+                                dx, dy, static_cast<float>(dt));
+                    report->AddUpdate(examples::Milliseconds(begin, Clock::now()));
+                }));
+            }
+
+            // Copied straight from the arrays into the batch, one color range at a time.
+            auto batch = std::make_shared<examples::QuadBatch>(box_count);
+            scene->set_render_function(bench.Render([boxes, batch, report](graphic::Canvas& canvas) {
+                Clock::time_point begin = Clock::now();
+                batch->Clear();
+                for (std::size_t c = 0; c < palette_size; ++c) {
+                    std::size_t first = boxes->color_begin[c];
+                    batch->AddRun(graphic::manager()->white_texture(), palette[c], boxes->x.data() + first,
+                                  boxes->y.data() + first, boxes->color_begin[c + 1] - first, box_size);
+                }
+                batch->Draw(canvas);
+                report->EndFrame(examples::Milliseconds(begin, Clock::now()));
+            }));
+        }
+    }
+    system::PushScene(std::move(scene));
+
+    system::Run();
+    system::Release();
+    return 0;
+}
@@ -0,0 +1,234 @@
+// Renders frames shaped like some of the examples with examples::SoftRasterizer,
+// on the CPU and without a window, and reports frame time and fill rate for each
+// combination of thread count and scalar, SSE2 or AVX2 spans.
+//
+// Workloads:
+//   draggable-box     one 50x50 box moving over a cleared frame
+//   many-boxes        10000 8x8 boxes in a palette of 8 colors
+//   joystick-display  seven display panels with sliders, buttons and their text
+//   overdraw          sixteen translucent full-frame quads
+//
+// Options:
+//   --width=N --height=N  framebuffer size (default 1280x720)
+//   --frames=N            frames measured for each case (default 60)
+//   --threads=N           largest thread count measured; every power of two up to
+//                         it is measured (default: hardware concurrency)
+//   --dump=DIR            write the last frame of each workload to DIR/<workload>.ppm
+//   --font=PATH           draw the joystick-display text with this font's glyphs at
+//                         16 pixels, rasterized by FreeType; without it, every
+//                         character is the same 16x16 ring
+
+#include <examples/glyphcache.h>
+#include <examples/mappedfile.h>
+#include <examples/softrasterizer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    typedef examples::SoftRasterizer Rasterizer;
+    typedef examples::Pixel Pixel;
+
+    struct Glyph {
+        Glyph(const examples::GlyphAtlas& atlas, const examples::GlyphMetrics& metrics)
+            : mask(metrics.width, metrics.height)
+            , bearing_x(metrics.bearing_x)
+            , bearing_y(metrics.bearing_y)
+            , advance(metrics.advance)
+        {
+            for (int y = 0; y < mask.height; ++y)
+                std::memcpy(&mask.coverage[y * mask.width], atlas.pixels() + (metrics.y + y) * atlas.width() + metrics.x,
+                            mask.width);
+        }
+
+        examples::SoftMask mask;
+        int bearing_x, bearing_y, advance;
+    };
+
+    // Shared by the workloads, like the textures and fonts of the examples.
+    struct Assets {
+        Assets()
+            : white(1, 1)
+            , glyph(16, 16)
+            , ascent(0)
+        {
+            // A ring with soft edges, standing in for an antialiased glyph.
+            for (int y = 0; y < glyph.height; ++y)
+                for (int x = 0; x < glyph.width; ++x) {
+                    double dx = x - 7.5, dy = y - 7.5;
+                    double distance = std::abs(std::sqrt(dx * dx + dy * dy) - 5.0);
+                    glyph.coverage[y * glyph.width + x] = static_cast<uint8_t>(255.0 * std::max(0.0, 1.0 - distance / 1.5));
+                }
+        }
+
+        // Printable ASCII from the font, indexed by character - ' '.
+        bool LoadFont(const std::string& path) {
+            examples::MappedFile file(path);
+            std::vector<uint32_t> codepoints;
+            for (uint32_t c = ' '; c <= '~'; ++c)
+                codepoints.push_back(c);
+            std::unique_ptr<examples::GlyphAtlas> atlas;
+            if (file.is_open())
+                atlas = examples::GlyphCache::Rasterize(file, 16, codepoints);
+            if (!atlas) {
+                std::fprintf(stderr, "Unable to rasterize '%s'.\n", path.c_str());
+                return false;
+            }
+            for (uint32_t c : codepoints) {
+                const examples::GlyphMetrics* metrics = atlas->Find(c);
+                if (!metrics)
+                    return false;
+                font.emplace_back(*atlas, *metrics);
+                ascent = std::max(ascent, font.back().bearing_y);
+            }
+            return true;
+        }
+
+        examples::SoftTexture white;
+        examples::SoftMask glyph;
+        std::vector<Glyph> font;
+        int ascent;
+    };
+
+    // Draws text with its top-left corner at (x, y).
+    void DrawText(Rasterizer& raster, const Assets& assets, double x, double y, const char* text, Pixel color) {
+        for (const char* c = text; *c; ++c) {
+            if (assets.font.empty()) {
+                raster.DrawMask(x, y, assets.glyph, color);
+                x += 9.0;
+                continue;
+            }
+            if (*c < ' ' || *c > '~')
+                continue;
+            const Glyph& glyph = assets.font[*c - ' '];
+            if (glyph.mask.width > 0 && glyph.mask.height > 0)
+                raster.DrawMask(std::floor(x) + glyph.bearing_x, std::floor(y) + assets.ascent - glyph.bearing_y,
+                                glyph.mask, color);
+            x += glyph.advance;
+        }
+    }
+
+    void DraggableBox(Rasterizer& raster, const Assets& assets, int frame) {
+        raster.Clear(examples::PackPixel(0.0, 0.0, 0.0));
+        double x = (frame * 7) % (raster.width() - 50), y = (frame * 3) % (raster.height() - 50);
+        raster.DrawTexture(x, y, 50.0, 50.0, assets.white);
+    }
+
+    void ManyBoxes(Rasterizer& raster, const Assets& assets, int frame) {
+        static const Pixel palette[] = {
+            examples::PackPixel(1.0, 0.3, 0.3), examples::PackPixel(0.3, 1.0, 0.3), examples::PackPixel(0.3, 0.3, 1.0),
+            examples::PackPixel(1.0, 1.0, 0.3), examples::PackPixel(1.0, 0.3, 1.0), examples::PackPixel(0.3, 1.0, 1.0),
+            examples::PackPixel(1.0, 0.6, 0.2), examples::PackPixel(0.8, 0.8, 0.8),
+        };
+        raster.Clear(examples::PackPixel(0.0, 0.0, 0.0));
+        std::minstd_rand random(42);
+        std::normal_distribution<double> spread(0.0, 0.15);
+        for (int i = 0; i < 10000; ++i) {
+            double x = (0.5 + spread(random)) * raster.width() + frame % 16;
+            double y = (0.5 + spread(random)) * raster.height();
+            raster.DrawTexture(x - 4.0, y - 4.0, 8.0, 8.0, assets.white, palette[i % 8]);
+        }
+    }
+
+    void JoystickDisplay(Rasterizer& raster, const Assets& assets, int frame) {
+        raster.Clear(examples::PackPixel(0.0, 0.0, 0.0));
+        Pixel gray = examples::PackPixel(0.5, 0.5, 0.5), green = examples::PackPixel(0.0, 1.0, 0.0);
+        Pixel text = examples::PackPixel(1.0, 1.0, 1.0);
+        for (int display = 0; display < 7; ++display) {
+            double top = 10.0 + display * 105.0;
+            raster.FillQuad(10.0, top, 1000.0, 100.0, examples::PackPixel(0.1, 0.1, 0.1));
+            char line[64];
+            std::snprintf(line, sizeof(line), "Joystick [0x%08x] -- 6 Axis, 1 Hat, 0 Balls, 12 Buttons", 0x1000 * display);
+            DrawText(raster, assets, 10.0, top, line, text);
+            for (int axis = 0; axis < 6; ++axis) {
+                double x = 40.0 + axis * 60.0, y = top + 50.0;
+                raster.FillQuad(x - 25.0, y - 5.0, 50.0, 10.0, gray);
+                raster.FillQuad(x - 2.5 + ((frame + axis) % 50) - 25.0, y - 5.0, 5.0, 10.0, green);
+                std::snprintf(line, sizeof(line), "%d", axis);
+                DrawText(raster, assets, x - 8.0, y - 26.0, line, text);
+            }
+            for (int button = 0; button < 12; ++button) {
+                double x = 420.0 + button * 30.0, y = top + 50.0;
+                raster.FillQuad(x - 10.0, y - 10.0, 20.0, 20.0, (frame + button) % 3 ? gray : green);
+                std::snprintf(line, sizeof(line), "%d", button);
+                DrawText(raster, assets, x - 8.0, y - 8.0, line, text);
+            }
+        }
+    }
+
+    void Overdraw(Rasterizer& raster, const Assets&, int frame) {
+        raster.Clear(examples::PackPixel(0.0, 0.0, 0.0));
+        for (int layer = 0; layer < 16; ++layer)
+            raster.FillQuad(0.0, 0.0, raster.width(), raster.height(),
+                            examples::PackPixel((layer + frame) % 4 / 3.0, layer % 2, 0.5, 0.25));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int width = 1280, height = 720, frames = 60;
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string dump_dir, font_path;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--width=", 8) == 0)
+            width = std::max(1, std::atoi(argv[i] + 8));
+        else if (std::strncmp(argv[i], "--height=", 9) == 0)
+            height = std::max(1, std::atoi(argv[i] + 9));
+        else if (std::strncmp(argv[i], "--frames=", 9) == 0)
+            frames = std::max(1, std::atoi(argv[i] + 9));
+        else if (std::strncmp(argv[i], "--threads=", 10) == 0)
+            max_threads = std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--dump=", 7) == 0)
+            dump_dir = argv[i] + 7;
+        else if (std::strncmp(argv[i], "--font=", 7) == 0)
+            font_path = argv[i] + 7;
+    }
+
+    struct Workload {
+        const char* name;
+        void (*draw)(Rasterizer&, const Assets&, int);
+    };
+    const Workload workloads[] = {
+        { "draggable-box", DraggableBox }, { "many-boxes", ManyBoxes },
+        { "joystick-display", JoystickDisplay }, { "overdraw", Overdraw },
+    };
+
+    Assets assets;
+    if (!font_path.empty() && !assets.LoadFont(font_path))
+        return 1;
+    const examples::SpanPath paths[] = { examples::SpanPath::SCALAR, examples::SpanPath::SSE2, examples::SpanPath::AVX2 };
+    printf("workload,threads,simd,ms_per_frame,mpixels_per_second\n");
+    for (const Workload& workload : workloads) {
+        for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+            Rasterizer raster(width, height, threads);
+            for (examples::SpanPath path : paths) {
+                if (!examples::SpanPathSupported(path))
+                    continue;
+                raster.set_path(path);
+                double total_ms = 0.0;
+                unsigned long long pixels = 0;
+                for (int frame = 0; frame < frames; ++frame) {
+                    Clock::time_point begin = Clock::now();
+                    workload.draw(raster, assets, frame);
+                    raster.Flush();
+                    total_ms += std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+                    pixels += raster.pixels_drawn();
+                }
+                printf("%s,%u,%s,%.3f,%.1f\n", workload.name, threads, examples::SpanPathName(path),
+                       total_ms / frames, pixels / (total_ms * 1000.0));
+            }
+            if (!dump_dir.empty() && threads * 2 > max_threads)
+                raster.WritePPM(dump_dir + "/" + workload.name + ".ppm");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+// Compares examples::SpatialGrid against a linear scan over every object for the
+// queries of many-draggable-boxes: top-most picks under a point, rectangle
+// queries, and the cost of keeping the grid updated as objects move.
+//
+// Objects are 12x12 boxes scattered over a square sized so that each covers on
+// average about a third of a box with others.
+//
+// Options:
+//   --objects=N    number of objects (default 100000)
+//   --queries=N    queries measured for each case (default 100000)
+//   --cell=SIZE    grid cell size (default 16)
+
+#include <examples/spatialgrid.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    typedef examples::SpatialGrid Grid;
+
+    const double box_size = 12.0;
+
+    struct Point {
+        double x, y;
+    };
+
+    double NanosecondsSince(Clock::time_point begin) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+    }
+
+    // Objects are stored in draw order, so the top-most is the last one that hits.
+    Grid::Id LinearPick(const std::vector<examples::Bounds>& objects, double x, double y) {
+        for (std::size_t i = objects.size(); i-- > 0;)
+            if (objects[i].Contains(x, y))
+                return i;
+        return Grid::NONE;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t num_objects = 100000, num_queries = 100000;
+    double cell = 16.0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--objects=", 10) == 0)
+            num_objects = std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--queries=", 10) == 0)
+            num_queries = std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--cell=", 7) == 0)
+            cell = std::max(1.0, std::atof(argv[i] + 7));
+    }
+
+    double side = std::sqrt(num_objects * box_size * box_size * 3.0);
+    std::default_random_engine engine(7);
+    std::uniform_real_distribution<double> coordinate(0.0, side);
+
+    std::vector<examples::Bounds> objects(num_objects);
+    Grid grid(examples::Bounds(0.0, 0.0, side, side), cell);
+    Clock::time_point build_begin = Clock::now();
+    for (std::size_t i = 0; i < num_objects; ++i) {
+        objects[i] = examples::Bounds::Centered(coordinate(engine), coordinate(engine), box_size, box_size);
+        grid.Insert(i, objects[i], static_cast<unsigned>(i));
+    }
+    double build_ns = NanosecondsSince(build_begin);
+
+    std::vector<Point> points(num_queries);
+    for (Point& point : points)
+        point = Point{ coordinate(engine), coordinate(engine) };
+
+    printf("case,objects,queries,linear_ns,grid_ns,speedup\n");
+    printf("build,%u,%u,0,%.1f,0\n", static_cast<unsigned>(num_objects), static_cast<unsigned>(num_objects),
+           build_ns / num_objects);
+
+    // Point picks. Both must agree on every result.
+    std::size_t mismatches = 0;
+    std::vector<Grid::Id> linear_results(num_queries), grid_results(num_queries);
+    Clock::time_point begin = Clock::now();
+    for (std::size_t i = 0; i < num_queries; ++i)
+        linear_results[i] = LinearPick(objects, points[i].x, points[i].y);
+    double linear_ns = NanosecondsSince(begin);
+    begin = Clock::now();
+    for (std::size_t i = 0; i < num_queries; ++i)
+        grid_results[i] = grid.Pick(points[i].x, points[i].y);
+    double grid_ns = NanosecondsSince(begin);
+    for (std::size_t i = 0; i < num_queries; ++i)
+        mismatches += linear_results[i] != grid_results[i];
+    printf("pick,%u,%u,%.1f,%.1f,%.1f\n", static_cast<unsigned>(num_objects), static_cast<unsigned>(num_queries),
+           linear_ns / num_queries, grid_ns / num_queries, linear_ns / std::max(grid_ns, 1.0));
+
+    // 64x64 rectangle queries, like a selection box.
+    std::vector<Grid::Id> result;
+    std::size_t linear_found = 0, grid_found = 0;
+    begin = Clock::now();
+    for (const Point& point : points) {
+        examples::Bounds rect(point.x, point.y, point.x + 64.0, point.y + 64.0);
+        result.clear();
+        for (std::size_t i = 0; i < num_objects; ++i)
+            if (objects[i].Intersects(rect))
+                result.push_back(i);
+        linear_found += result.size();
+    }
+    linear_ns = NanosecondsSince(begin);
+    begin = Clock::now();
+    for (const Point& point : points) {
+        result.clear();
+        grid.QueryRect(examples::Bounds(point.x, point.y, point.x + 64.0, point.y + 64.0), result);
+        grid_found += result.size();
+    }
+    grid_ns = NanosecondsSince(begin);
+    mismatches += linear_found != grid_found;
+    printf("rect,%u,%u,%.1f,%.1f,%.1f\n", static_cast<unsigned>(num_objects), static_cast<unsigned>(num_queries),
+           linear_ns / num_queries, grid_ns / num_queries, linear_ns / std::max(grid_ns, 1.0));
+
+    // Drags: small random steps, like objects following the mouse.
+    std::uniform_real_distribution<double> step(-4.0, 4.0);
+    std::uniform_int_distribution<std::size_t> object_dist(0, num_objects - 1);
+    begin = Clock::now();
+    for (std::size_t i = 0; i < num_queries; ++i) {
+        std::size_t id = object_dist(engine);
+        examples::Bounds& bounds = objects[id];
+        double dx = step(engine), dy = step(engine);
+        bounds = examples::Bounds(bounds.min_x + dx, bounds.min_y + dy, bounds.max_x + dx, bounds.max_y + dy);
+        grid.Move(id, bounds);
+    }
+    grid_ns = NanosecondsSince(begin);
+    printf("move,%u,%u,0,%.1f,0\n", static_cast<unsigned>(num_objects), static_cast<unsigned>(num_queries),
+           grid_ns / num_queries);
+
+    if (mismatches > 0) {
+        fprintf(stderr, "%u results differ between the linear scan and the grid.\n", static_cast<unsigned>(mismatches));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,149 @@
+// Measures how the frame time of a scene with many independent tasks scales with
+// the number of threads running examples::ParallelTaskGroup.
+//
+// The synthetic scene has groups of simulation tasks, each writing its own data;
+// a collision task per group reads the group's data, and a final task without
+// declared data runs on the main thread, like a task that talks to the engine.
+//
+// Options:
+//   --tasks=N        simulation tasks (default 64)
+//   --group-size=N   simulation tasks per collision task (default 8)
+//   --work=N         iterations of work per task (default 20000)
+//   --frames=N       frames measured for each thread count (default 200)
+//   --max-threads=N  largest number of threads (default 16)
+
+#include <examples/paralleltasks.h>
+#include <examples/workstealingpool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    struct Body {
+        float x, y, vx, vy;
+    };
+
+    // Some floating point work over a task's own bodies.
+    void Simulate(std::vector<Body>& bodies, int work, double dt) {
+        float fdt = static_cast<float>(dt);
+        int steps = std::max(1, work / static_cast<int>(bodies.size()));
+        for (int step = 0; step < steps; ++step) {
+            for (Body& body : bodies) {
+                float distance = std::sqrt(body.x * body.x + body.y * body.y) + 1.0f;
+                body.vx -= body.x / (distance * distance * distance) * fdt;
+                body.vy -= body.y / (distance * distance * distance) * fdt;
+                body.x += body.vx * fdt;
+                body.y += body.vy * fdt;
+            }
+        }
+    }
+
+    float Collide(const std::vector<std::vector<Body>>& groups, std::size_t first, std::size_t count) {
+        float closest = 1e30f;
+        for (std::size_t i = first; i < first + count; ++i)
+            for (const Body& body : groups[i])
+                closest = std::min(closest, body.x * body.x + body.y * body.y);
+        return closest;
+    }
+
+    struct Result {
+        double ms_per_frame;
+        double p99_ms;
+    };
+
+    Result Run(unsigned threads, int num_tasks, int group_size, int work, int frames) {
+        examples::WorkStealingPool pool(threads - 1);
+        examples::ParallelTaskGroup tasks(pool);
+
+        std::vector<std::vector<Body>> bodies(num_tasks, std::vector<Body>(64));
+        for (int i = 0; i < num_tasks; ++i)
+            for (std::size_t b = 0; b < bodies[i].size(); ++b) {
+                Body body = { 1.0f + b * 0.1f, 0.5f * i, 0.0f, 1.0f };
+                bodies[i][b] = body;
+            }
+        int num_groups = (num_tasks + group_size - 1) / group_size;
+        std::vector<float> collisions(num_groups);
+        float checksum = 0.0f;
+
+        for (int i = 0; i < num_tasks; ++i) {
+            std::vector<Body>* data = &bodies[i];
+            tasks.Add([data, work](double dt) { Simulate(*data, work, dt); }, {}, {data});
+        }
+        for (int g = 0; g < num_groups; ++g) {
+            std::size_t first = g * group_size;
+            std::size_t count = std::min<std::size_t>(group_size, num_tasks - first);
+            float* result = &collisions[g];
+            const std::vector<std::vector<Body>>* all = &bodies;
+            // Reads every body of its group, so it waits for that group's simulation tasks.
+            examples::ParallelTaskGroup::DataList reads;
+            for (std::size_t i = first; i < first + count; ++i)
+                reads.push_back(&bodies[i]);
+            tasks.Add([all, first, count, result](double) { *result = Collide(*all, first, count); },
+                      reads, {result});
+        }
+        tasks.Add([&collisions, &checksum](double) {
+            for (float collision : collisions)
+                checksum += collision;
+        });
+
+        std::vector<double> frame_ms;
+        frame_ms.reserve(frames);
+        for (int frame = 0; frame < frames; ++frame) {
+            Clock::time_point begin = Clock::now();
+            tasks.Run(1.0 / 60.0);
+            frame_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - begin).count());
+        }
+        if (checksum == 42.0f)
+            printf("\n");
+
+        Result result;
+        double total = 0.0;
+        for (double ms : frame_ms)
+            total += ms;
+        result.ms_per_frame = total / frames;
+        std::sort(frame_ms.begin(), frame_ms.end());
+        result.p99_ms = frame_ms[frame_ms.size() * 99 / 100];
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int num_tasks = 64;
+    int group_size = 8;
+    int work = 20000;
+    int frames = 200;
+    unsigned max_threads = 16;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--tasks=", 8) == 0)
+            num_tasks = std::max(1, std::atoi(argv[i] + 8));
+        else if (std::strncmp(argv[i], "--group-size=", 13) == 0)
+            group_size = std::max(1, std::atoi(argv[i] + 13));
+        else if (std::strncmp(argv[i], "--work=", 7) == 0)
+            work = std::max(1, std::atoi(argv[i] + 7));
+        else if (std::strncmp(argv[i], "--frames=", 9) == 0)
+            frames = std::max(1, std::atoi(argv[i] + 9));
+        else if (std::strncmp(argv[i], "--max-threads=", 14) == 0)
+            max_threads = static_cast<unsigned>(std::max(1, std::atoi(argv[i] + 14)));
+    }
+
+    printf("%d tasks in groups of %d, %d iterations each, %u hardware threads\n",
+           num_tasks, group_size, work, std::thread::hardware_concurrency());
+    printf("threads,ms_per_frame,p99_ms,speedup\n");
+    double single = 0.0;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        Result r = Run(threads, num_tasks, group_size, work, frames);
+        if (threads == 1)
+            single = r.ms_per_frame;
+        printf("%u,%.3f,%.3f,%.2f\n", threads, r.ms_per_frame, r.p99_ms, single / r.ms_per_frame);
+    }
+    return 0;
+}
@@ -7,8 +7,10 @@
 #include <ugdk/text/label.h>
 #include <ugdk/text/textbox.h>
 #include <ugdk/system/compatibility.h>
-#include <ugdk/filesystem/module.h>
-#include <ugdk/filesystem/file.h>
+
+#include <examples/assetloader.h>
+#include <examples/benchmark.h>
+#include <examples/loadingscene.h>
 
 #include <string>
 #include <memory>
@@ -21,29 +23,42 @@ void QuitOnEscape(const ugdk::input::KeyPressedEvent& ev) {
 }
 
 int main(int argc, char* argv[]) {
+    examples::StartupTimer startup;
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+
     system::Configuration config;
     // EXAMPLE_LOCATION is defined by CMake to be the full path to the directory
     // that contains the source code for this example
     config.base_path = EXAMPLE_LOCATION "/content/"; 
+    bench.Configure(config);
     system::Initialize(config);
 
-    text::manager()->AddFont("default", "epgyosho.ttf", 30);
+    // Files are read by the loader's threads while the loading scene is shown.
+    examples::AssetLoader loader(config.base_path, examples::ParseLoadingOptions(argc, argv));
+    auto font = loader.LoadFont("default", "epgyosho.ttf", 30);
+    auto hello = loader.LoadView("hello.txt");
+    auto touhou = loader.LoadTextBox("touhou.txt", "default");
+
+    examples::PushLoadingScene(loader, [&] {
+        auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+        bench.Attach(*scene);
+        scene->event_handler().AddListener(QuitOnEscape);
 
-    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
-    scene->event_handler().AddListener(QuitOnEscape);
-    {
-        auto file = ugdk::filesystem::manager()->OpenFile("hello.txt");
-        auto label = std::make_shared<text::Label>(file->GetContents(), text::manager()->GetFont("default"));
-        auto box = std::shared_ptr<text::TextBox>(text::manager()->GetTextFromFile("touhou.txt", "default"));
+        // The futures are dropped so the scene holds the only references, and the
+        // box and its labels go away with it, before the engine is released.
+        auto label = std::make_shared<text::Label>(hello.get().str(), font.get());
+        hello = std::shared_future<examples::AssetView>();
+        auto box = touhou.get();
+        touhou = std::shared_future<std::shared_ptr<text::TextBox>>();
 
-        scene->set_render_function([=](graphic::Canvas& canvas) {
+        scene->set_render_function(bench.Render(startup.FirstFrame([=](graphic::Canvas& canvas) {
             label->Draw(canvas);
             canvas.PushAndCompose(graphic::Geometry(math::Vector2D(0, label->height() + 50)));
             box->Draw(canvas);
             canvas.PopGeometry();
-        });
-    }
-    system::PushScene(std::move(scene));
+        })));
+        return scene;
+    });
 
     system::Run();
     system::Release();
@@ -0,0 +1,97 @@
+#include <ugdk/system/engine.h>
+#include <ugdk/system/configuration.h>
+#include <ugdk/system/compatibility.h>
+#include <ugdk/action/scene.h>
+#include <ugdk/input/events.h>
+#include <ugdk/graphic/canvas.h>
+#include <ugdk/text/module.h>
+
+#include <examples/benchmark.h>
+#include <examples/clock.h>
+#include <examples/processmemory.h>
+#include <examples/streamingtextbox.h>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+using namespace ugdk;
+
+// Shows a text file of any size with examples::StreamingTextBox.
+//
+// Usage: example-text-viewer [FILE]
+// Scroll with the arrow keys, Page Up/Down, Home/End or the mouse wheel.
+
+namespace {
+    const math::Vector2D canvas_size(1280.0, 720.0);
+    typedef std::chrono::steady_clock Clock;
+}
+
+int main(int argc, char* argv[]) {
+    Clock::time_point start = Clock::now();
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+
+    // EXAMPLE_LOCATION is defined by CMake to be the full path to the directory
+    // that contains the source code for this example
+    std::string path = EXAMPLE_LOCATION "/../text-from-files/content/touhou.txt";
+    for (int i = 1; i < argc; ++i)
+        if (!examples::IsBenchmarkOption(argv[i]))
+            path = argv[i];
+
+    system::Configuration config;
+    config.canvas_size = canvas_size;
+    config.windows_list[0].size = canvas_size;
+    config.base_path = EXAMPLE_LOCATION "/../text-from-files/content/";
+    bench.Configure(config);
+    system::Initialize(config);
+
+    text::manager()->AddFont("default", "epgyosho.ttf", 20);
+
+    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+    bench.Attach(*scene);
+    {
+        std::size_t memory_before = examples::ResidentSetSize();
+        Clock::time_point open_begin = Clock::now();
+        auto box = std::make_shared<examples::StreamingTextBox>(path, text::manager()->GetFont("default"), canvas_size);
+        Clock::time_point open_end = Clock::now();
+        if (!box->is_open())
+            fprintf(stderr, "Unable to open '%s'.\n", path.c_str());
+        printf("'%s': %.1f MiB, opened in %.3f ms, %ld KiB resident memory\n", path.c_str(),
+               box->file_size() / (1024.0 * 1024.0), examples::Milliseconds(open_begin, open_end),
+               (static_cast<long>(examples::ResidentSetSize()) - static_cast<long>(memory_before)) / 1024);
+
+        scene->event_handler().AddListener<input::KeyPressedEvent>([box](const input::KeyPressedEvent& ev) {
+            long page = static_cast<long>(box->visible_lines());
+            switch (ev.scancode) {
+            case input::Scancode::ESCAPE:   system::CurrentScene().Finish(); break;
+            case input::Scancode::UP:       box->Scroll(-1); break;
+            case input::Scancode::DOWN:     box->Scroll(1); break;
+            case input::Scancode::PAGEUP:   box->Scroll(-page); break;
+            case input::Scancode::PAGEDOWN: box->Scroll(page); break;
+            case input::Scancode::HOME:     box->ScrollTo(0); break;
+            case input::Scancode::END:      box->ScrollToEnd(); break;
+            default: break;
+            }
+        });
+        scene->event_handler().AddListener<input::MouseWheelEvent>([box](const input::MouseWheelEvent& ev) {
+            box->Scroll(-3 * ev.scroll.y);
+        });
+
+        auto first_frame = std::make_shared<bool>(true);
+        scene->set_render_function(bench.Render([box, first_frame, start](graphic::Canvas& canvas) {
+            box->Draw(canvas);
+            if (*first_frame) {
+                *first_frame = false;
+                printf("First frame after %.3f ms, %ld KiB resident memory, %u bytes of line index\n",
+                       examples::Milliseconds(start, Clock::now()), static_cast<long>(examples::ResidentSetSize() / 1024),
+                       static_cast<unsigned>(box->index_memory()));
+            }
+        }));
+    }
+    system::PushScene(std::move(scene));
+
+    system::Run();
+    system::Release();
+    return 0;
+}
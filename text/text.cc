@@ -2,10 +2,14 @@
 #include <ugdk/action/scene.h>
 #include <ugdk/input/events.h>
 #include <ugdk/graphic/canvas.h>
-#include <ugdk/text/module.h>
-#include <ugdk/text/label.h>
 #include <ugdk/system/compatibility.h>
 
+#include <examples/assetloader.h>
+#include <examples/atlastext.h>
+#include <examples/benchmark.h>
+#include <examples/loadingscene.h>
+#include <examples/quadbatch.h>
+
 #include <string>
 #include <memory>
 
@@ -17,28 +21,41 @@ void QuitOnEscape(const ugdk::input::KeyPressedEvent& ev) {
 }
 
 int main(int argc, char* argv[]) {
+    examples::StartupTimer startup;
+    examples::FrameBenchmark bench(examples::ParseBenchmarkOptions(argc, argv));
+
     system::Configuration config;
     // EXAMPLE_LOCATION is defined by CMake to be the full path to the directory
     // that contains the source code for this example
     config.base_path = EXAMPLE_LOCATION "/content/"; 
+    bench.Configure(config);
     system::Initialize(config);
 
-    text::manager()->AddFont("default", "epgyosho.ttf", 40);
-
-    auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
-    scene->event_handler().AddListener(QuitOnEscape);
-    {
-        auto label = std::make_shared<text::Label>("Hello World!",
-                                                   text::manager()->GetFont("default"));
-        label->set_hotspot(ui::HookPoint::CENTER);
-
-        scene->set_render_function([=](graphic::Canvas& canvas) {
-            canvas.PushAndCompose(canvas.size() * 0.5);
-            label->Draw(canvas);
-            canvas.PopGeometry();
-        });
-    }
-    system::PushScene(std::move(scene));
+    // The font is read and rasterized by the loader's threads while the loading
+    // scene is shown, then uploaded as a glyph atlas.
+    examples::AssetLoader loader(config.base_path, examples::ParseLoadingOptions(argc, argv));
+    auto font_future = examples::LoadAtlasFont(loader, "epgyosho.ttf", 40, examples::AsciiCodepoints());
+
+    examples::PushLoadingScene(loader, [&] {
+        auto scene = ugdk::MakeUnique<ugdk::action::Scene>();
+        bench.Attach(*scene);
+        scene->event_handler().AddListener(QuitOnEscape);
+
+        // The future is dropped so the render function holds the only reference, and
+        // the atlas texture goes away with the scene, before the engine is released.
+        std::shared_ptr<examples::AtlasFont> font = font_future.get();
+        font_future = std::shared_future<std::shared_ptr<examples::AtlasFont>>();
+        auto batch = std::make_shared<examples::QuadBatch>();
+
+        scene->set_render_function(bench.Render(startup.FirstFrame([font, batch](graphic::Canvas& canvas) {
+            if (!font)
+                return;
+            batch->Clear();
+            font->AddText(*batch, "Hello World!", canvas.size() * 0.5, Color(1.0, 1.0, 1.0), math::Vector2D(0.5, 0.5));
+            batch->Draw(canvas);
+        })));
+        return scene;
+    });
 
     system::Run();
     system::Release();
@@ -0,0 +1,257 @@
+// Compares the per-frame cost of recomputing every world transform, as a full
+// ui::Node render traversal does, against a TransformTree's cached
+// transforms with dirty propagation, when 0%, 1% and 100% of the nodes change.
+//
+// Trees:
+//   deep      binary tree, 16 levels
+//   wide      a root with every other node as its child
+//   displays  shaped like joystick-display: displays with a few sections of widgets
+//
+// Options:
+//   --nodes=N    approximate number of nodes in each tree (default 65536)
+//   --frames=N   frames measured for each case (default 200)
+
+#include <examples/batchtransform.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+    typedef examples::Affine2D Affine2D;
+
+    struct RGBA {
+        RGBA() : r(1.0), g(1.0), b(1.0), a(1.0) {}
+        RGBA(double r, double g, double b, double a = 1.0) : r(r), g(g), b(b), a(a) {}
+
+        RGBA operator*(const RGBA& other) const {
+            return RGBA(r * other.r, g * other.g, b * other.b, a * other.a);
+        }
+
+        double r, g, b, a;
+    };
+
+    // A hierarchy of local transforms and colors that caches each node's world
+    // transform and color, the way ui::Node composes them through the canvas stack
+    // when rendering.
+    //
+    // Changing a node only marks it dirty; Update then recomputes the subtrees of the
+    // dirty nodes and nothing else, so a frame where nothing moved costs nothing.
+    // UpdateAll recomputes every node, like a full render traversal does.
+    class TransformTree {
+      public:
+        typedef std::size_t NodeId;
+        static const NodeId ROOT = 0;
+
+        TransformTree() {
+            nodes_.push_back(Node(ROOT, 0));
+        }
+
+        NodeId AddChild(NodeId parent) {
+            NodeId id = nodes_.size();
+            nodes_.push_back(Node(parent, nodes_[parent].depth + 1));
+            nodes_[parent].children.push_back(id);
+            MarkDirty(id);
+            return id;
+        }
+
+        std::size_t size() const { return nodes_.size(); }
+        NodeId parent(NodeId id) const { return nodes_[id].parent; }
+
+        const Affine2D& local_transform(NodeId id) const { return nodes_[id].local; }
+        const RGBA& local_color(NodeId id) const { return nodes_[id].local_color; }
+
+        void set_transform(NodeId id, const Affine2D& transform) {
+            nodes_[id].local = transform;
+            MarkDirty(id);
+        }
+
+        void set_offset(NodeId id, double x, double y) {
+            nodes_[id].local.tx = x;
+            nodes_[id].local.ty = y;
+            MarkDirty(id);
+        }
+
+        void set_color(NodeId id, const RGBA& color) {
+            nodes_[id].local_color = color;
+            MarkDirty(id);
+        }
+
+        // Valid after Update or UpdateAll.
+        const Affine2D& world_transform(NodeId id) const { return nodes_[id].world; }
+        const RGBA& world_color(NodeId id) const { return nodes_[id].world_color; }
+
+        bool dirty(NodeId id) const { return nodes_[id].dirty; }
+        std::size_t num_dirty() const { return dirty_.size(); }
+
+        // Recomputes the world state of the dirty nodes and their descendants, from the
+        // shallowest dirty node down, or of every node when most are dirty. Returns how
+        // many nodes were recomputed.
+        std::size_t Update() {
+            if (dirty_.empty())
+                return 0;
+            // With this many dirty nodes sorting costs more than it saves.
+            if (dirty_.size() * 4 > nodes_.size())
+                return UpdateAll();
+            std::sort(dirty_.begin(), dirty_.end(), [this](NodeId x, NodeId y) {
+                return nodes_[x].depth < nodes_[y].depth;
+            });
+            std::size_t recomputed = 0;
+            for (NodeId id : dirty_)
+                // Already recomputed along with a dirty ancestor.
+                if (nodes_[id].dirty)
+                    recomputed += UpdateSubtree(id);
+            dirty_.clear();
+            return recomputed;
+        }
+
+        // Recomputes every node, dirty or not.
+        std::size_t UpdateAll() {
+            dirty_.clear();
+            return UpdateSubtree(ROOT);
+        }
+
+      private:
+        struct Node {
+            Node(NodeId parent, unsigned depth) : parent(parent), depth(depth), dirty(false) {}
+
+            Affine2D local, world;
+            RGBA local_color, world_color;
+            NodeId parent;
+            unsigned depth;
+            bool dirty;
+            std::vector<NodeId> children;
+        };
+
+        void MarkDirty(NodeId id) {
+            if (nodes_[id].dirty)
+                return;
+            nodes_[id].dirty = true;
+            dirty_.push_back(id);
+        }
+
+        // Iterative, since trees can be deeper than the call stack.
+        std::size_t UpdateSubtree(NodeId root) {
+            std::size_t count = 0;
+            stack_.push_back(root);
+            while (!stack_.empty()) {
+                NodeId id = stack_.back();
+                stack_.pop_back();
+                Node& node = nodes_[id];
+                if (id == ROOT) {
+                    node.world = node.local;
+                    node.world_color = node.local_color;
+                } else {
+                    const Node& parent = nodes_[node.parent];
+                    node.world = parent.world * node.local;
+                    node.world_color = parent.world_color * node.local_color;
+                }
+                node.dirty = false;
+                ++count;
+                stack_.insert(stack_.end(), node.children.begin(), node.children.end());
+            }
+            return count;
+        }
+
+        std::vector<Node> nodes_;
+        std::vector<NodeId> dirty_;
+        std::vector<NodeId> stack_;
+    };
+
+    typedef TransformTree Tree;
+
+    void BuildDeep(Tree& tree, std::size_t nodes) {
+        for (Tree::NodeId parent = 0; tree.size() < nodes; ++parent) {
+            tree.AddChild(parent);
+            if (tree.size() < nodes)
+                tree.AddChild(parent);
+        }
+    }
+
+    void BuildWide(Tree& tree, std::size_t nodes) {
+        while (tree.size() < nodes)
+            tree.AddChild(Tree::ROOT);
+    }
+
+    // Each display has 3 sections of 16 widgets, and each widget a background,
+    // a marker and a label.
+    void BuildDisplays(Tree& tree, std::size_t nodes) {
+        while (tree.size() < nodes) {
+            Tree::NodeId display = tree.AddChild(Tree::ROOT);
+            for (int section = 0; section < 3; ++section) {
+                Tree::NodeId section_node = tree.AddChild(display);
+                for (int widget = 0; widget < 16; ++widget) {
+                    Tree::NodeId widget_node = tree.AddChild(section_node);
+                    for (int part = 0; part < 3; ++part)
+                        tree.AddChild(widget_node);
+                }
+            }
+        }
+    }
+
+    // Average ns per frame, changing `changed` random nodes before each update.
+    double Measure(Tree& tree, std::size_t changed, bool cached, int frames, std::size_t& recomputed) {
+        std::default_random_engine engine(7);
+        std::uniform_int_distribution<std::size_t> node_dist(1, tree.size() - 1);
+        std::vector<Tree::NodeId> targets(changed);
+        tree.UpdateAll();
+        recomputed = 0;
+        double total_ns = 0.0;
+        for (int frame = 0; frame < frames; ++frame) {
+            if (changed == tree.size() - 1) {
+                for (std::size_t i = 0; i < changed; ++i)
+                    targets[i] = i + 1;
+            } else {
+                for (Tree::NodeId& target : targets)
+                    target = node_dist(engine);
+            }
+            Clock::time_point begin = Clock::now();
+            for (Tree::NodeId target : targets)
+                tree.set_offset(target, frame * 0.5, target * 0.25);
+            recomputed += cached ? tree.Update() : tree.UpdateAll();
+            total_ns += std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        }
+        recomputed /= frames;
+        return total_ns / frames;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t nodes = 65536;
+    int frames = 200;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--nodes=", 8) == 0)
+            nodes = std::max(2, std::atoi(argv[i] + 8));
+        else if (std::strncmp(argv[i], "--frames=", 9) == 0)
+            frames = std::max(1, std::atoi(argv[i] + 9));
+    }
+
+    struct Shape {
+        const char* name;
+        void (*build)(Tree&, std::size_t);
+    };
+    const Shape shapes[] = { { "deep", BuildDeep }, { "wide", BuildWide }, { "displays", BuildDisplays } };
+    const double fractions[] = { 0.0, 0.01, 1.0 };
+
+    printf("tree,nodes,changed_percent,full_us,cached_us,cached_nodes_recomputed,speedup\n");
+    for (const Shape& shape : shapes) {
+        Tree tree;
+        shape.build(tree, nodes);
+        for (double fraction : fractions) {
+            std::size_t changed = static_cast<std::size_t>((tree.size() - 1) * fraction);
+            std::size_t full_count, cached_count;
+            double full_ns = Measure(tree, changed, false, frames, full_count);
+            double cached_ns = Measure(tree, changed, true, frames, cached_count);
+            printf("%s,%u,%g,%.1f,%.1f,%u,%.2f\n", shape.name, static_cast<unsigned>(tree.size()), fraction * 100.0,
+                   full_ns / 1000.0, cached_ns / 1000.0, static_cast<unsigned>(cached_count),
+                   full_ns / std::max(cached_ns, 1.0));
+        }
+    }
+    return 0;
+}